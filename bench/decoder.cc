@@ -0,0 +1,126 @@
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <boost/algorithm/string.hpp>
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <decoder/sax.h>
+#include <decoder/simd.h>
+
+// a page of /users/{login}/repos?per_page=100, the fields and the size of the items are the ones of the api
+static std::string repos_page() {
+  std::string body = "[";
+  for (int i = 0; i < 100; i++) {
+    if (i != 0) {
+      body += ",";
+    }
+    body += fmt::format(R"({{"id": {0}, "node_id": "MDEwOlJlcG9zaXRvcnk{0}", "name": "repo-{0}", "full_name": "octocat/repo-{0}", "private": false,
+      "owner": {{"login": "octocat", "id": 583231, "node_id": "MDQ6VXNlcjU4MzIzMQ==", "avatar_url": "https://avatars.githubusercontent.com/u/583231?v=4",
+        "gravatar_id": "", "url": "https://api.github.com/users/octocat", "html_url": "https://github.com/octocat",
+        "followers_url": "https://api.github.com/users/octocat/followers", "following_url": "https://api.github.com/users/octocat/following{{/other_user}}",
+        "gists_url": "https://api.github.com/users/octocat/gists{{/gist_id}}", "starred_url": "https://api.github.com/users/octocat/starred{{/owner}}{{/repo}}",
+        "subscriptions_url": "https://api.github.com/users/octocat/subscriptions", "organizations_url": "https://api.github.com/users/octocat/orgs",
+        "repos_url": "https://api.github.com/users/octocat/repos", "events_url": "https://api.github.com/users/octocat/events{{/privacy}}",
+        "received_events_url": "https://api.github.com/users/octocat/received_events", "type": "User", "site_admin": false}},
+      "html_url": "https://github.com/octocat/repo-{0}", "description": "My repository number {0}", "fork": false,
+      "url": "https://api.github.com/repos/octocat/repo-{0}", "forks_url": "https://api.github.com/repos/octocat/repo-{0}/forks",
+      "keys_url": "https://api.github.com/repos/octocat/repo-{0}/keys{{/key_id}}", "hooks_url": "https://api.github.com/repos/octocat/repo-{0}/hooks",
+      "issue_events_url": "https://api.github.com/repos/octocat/repo-{0}/issues/events{{/number}}", "events_url": "https://api.github.com/repos/octocat/repo-{0}/events",
+      "branches_url": "https://api.github.com/repos/octocat/repo-{0}/branches{{/branch}}", "tags_url": "https://api.github.com/repos/octocat/repo-{0}/tags",
+      "commits_url": "https://api.github.com/repos/octocat/repo-{0}/commits{{/sha}}", "pulls_url": "https://api.github.com/repos/octocat/repo-{0}/pulls{{/number}}",
+      "created_at": "2011-01-26T19:01:12Z", "updated_at": "2023-01-26T19:14:43Z", "pushed_at": "2023-01-26T19:06:43Z",
+      "git_url": "git://github.com/octocat/repo-{0}.git", "ssh_url": "git@github.com:octocat/repo-{0}.git", "clone_url": "https://github.com/octocat/repo-{0}.git",
+      "svn_url": "https://github.com/octocat/repo-{0}", "homepage": null, "size": {1}, "stargazers_count": {2}, "watchers_count": {2},
+      "language": "C++", "has_issues": true, "has_projects": true, "has_downloads": true, "has_wiki": true, "has_pages": false,
+      "has_discussions": false, "forks_count": 3, "mirror_url": null, "archived": false, "disabled": false, "open_issues_count": 1,
+      "license": {{"key": "mit", "name": "MIT License", "spdx_id": "MIT", "url": "https://api.github.com/licenses/mit", "node_id": "MDc6TGljZW5zZTEz"}},
+      "allow_forking": true, "is_template": false, "web_commit_signoff_required": false, "topics": ["c", "spider", "crawler"],
+      "visibility": "public", "forks": 3, "open_issues": 1, "watchers": {2}, "default_branch": "master"}})",
+                        i, i * 13, i * 7);
+  }
+  return body + "]";
+}
+
+const std::string body = repos_page();
+
+// the path of Request::request_page before the decoders, a plain parse, the callback parse and the copy out of the dom
+static void decode_dom(benchmark::State &state) {
+  for (auto _ : state) {
+    nlohmann::json content = nlohmann::json::parse(body);
+    nlohmann::json::parser_callback_t cb =
+        [=](int /*depth*/, nlohmann::json::parse_event_t event, nlohmann::json &parsed) {
+          if (event == nlohmann::json::parse_event_t::key) {
+            std::string str = parsed.dump();
+            str.erase(str.begin(), str.begin() + 1);
+            str.erase(str.end() - 1, str.end());
+            if (boost::algorithm::ends_with(str, "_url") or str == "url") {
+              return false;
+            }
+          } else if (event == nlohmann::json::parse_event_t::value && parsed.dump() == "null") {
+            parsed = nlohmann::json("");
+            return true;
+          }
+          return true;
+        };
+    content = nlohmann::json::parse(body, cb);
+    std::vector<Repo> repos;
+    for (auto &&con : content) {
+      Repo repo{
+          .id = con["id"].get<int64_t>(),
+          .node_id = con["node_id"].get<std::string>(),
+          .name = con["name"].get<std::string>(),
+          .full_name = con["full_name"].get<std::string>(),
+          .xprivate = con["private"].get<bool>(),
+          .owner = con["owner"]["login"].get<std::string>(),
+          .owner_type = con["owner"]["type"].get<std::string>(),
+          .description = con["description"].get<std::string>(),
+          .fork = con["fork"].get<bool>(),
+          .created_at = con["created_at"].get<std::string>(),
+          .updated_at = con["updated_at"].get<std::string>(),
+          .pushed_at = con["pushed_at"].get<std::string>(),
+          .homepage = con["homepage"].get<std::string>(),
+          .size = con["size"].get<int64_t>(),
+          .stargazers_count = con["stargazers_count"].get<int64_t>(),
+          .watchers_count = con["watchers_count"].get<int64_t>(),
+          .forks_count = con["forks_count"].get<int64_t>(),
+          .language = con["language"].get<std::string>(),
+          .forks = con["forks"].get<int64_t>(),
+          .open_issues = con["open_issues"].get<int64_t>(),
+          .watchers = con["watchers"].get<int64_t>(),
+          .default_branch = con["default_branch"].get<std::string>(),
+      };
+      if (!con["license"].is_string()) {
+        repo.license = con["license"]["key"].get<std::string>();
+      }
+      repos.push_back(repo);
+    }
+    benchmark::DoNotOptimize(repos);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * body.size()));
+}
+BENCHMARK(decode_dom);
+
+static void decode_sax(benchmark::State &state) {
+  SaxDecoder decoder;
+  for (auto _ : state) {
+    std::vector<Repo> repos;
+    decoder.decode_repos(body, repos);
+    benchmark::DoNotOptimize(repos);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * body.size()));
+}
+BENCHMARK(decode_sax);
+
+static void decode_simd(benchmark::State &state) {
+  SimdDecoder decoder;
+  for (auto _ : state) {
+    std::vector<Repo> repos;
+    decoder.decode_repos(body, repos);
+    benchmark::DoNotOptimize(repos);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * body.size()));
+}
+BENCHMARK(decode_simd);
+
+BENCHMARK_MAIN();
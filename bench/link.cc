@@ -0,0 +1,50 @@
+#include <regex>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include <link.h>
+
+const std::string header = R"(<https://api.github.com/user/1/followers?per_page=100&page=2>; rel="prev", )"
+                           R"(<https://api.github.com/user/1/followers?per_page=100&page=4>; rel="next", )"
+                           R"(<https://api.github.com/user/1/followers?per_page=100&page=1260>; rel="last", )"
+                           R"(<https://api.github.com/user/1/followers?per_page=100&page=1>; rel="first")";
+const std::string url_prefix = "https://api.github.com";
+
+// the regex path of Request::request before the hand written parser
+static std::string next_by_regex(std::string header_link) {
+  std::regex pieces_regex(R"lit(<(https:\/\/api\.github\.com\/[0-9a-z\/\?_=&]+)>;\srel="(next|last|prev|first)")lit");
+  std::smatch result;
+  while (!header_link.empty() && regex_search(header_link, result, pieces_regex)) {
+    if (result.size() == 3 && result[2] == "next") {
+      auto u = std::string(result[1]);
+      size_t pos = u.find(url_prefix);
+      if (pos != std::string::npos) {
+        u.erase(pos, url_prefix.length());
+      }
+      return u;
+    }
+    header_link = result.suffix().str();
+  }
+  return "";
+}
+
+static void link_regex(benchmark::State &state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(next_by_regex(header));
+  }
+}
+BENCHMARK(link_regex);
+
+static void link_parser(benchmark::State &state) {
+  for (auto _ : state) {
+    LinkHeader link = parse_link(header);
+    std::string_view origin, path;
+    split_url(link.next, origin, path);
+    benchmark::DoNotOptimize(path);
+    benchmark::DoNotOptimize(link_page(link.last));
+  }
+}
+BENCHMARK(link_parser);
+
+BENCHMARK_MAIN();
@@ -5,6 +5,7 @@
 #include <prometheus/registry.h>
 
 #include <config.h>
+#include <metrics.h>
 
 #include <application.h>
 #include <database.h>
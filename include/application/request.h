@@ -1,21 +1,34 @@
 #include <ctime>
 #include <iostream>
-#include <regex>
 #include <string>
 #include <thread>
 #include <utility>
 
 #include <boost/algorithm/string.hpp>
-#include <boost/random.hpp>
 #include <fort.hpp>
-#define CPPHTTPLIB_OPENSSL_SUPPORT
-#include <httplib.h>
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 #include <yaml-cpp/yaml.h>
 
 #include <application.h>
 #include <database.h>
+#include <decoder.h>
+#include <decoder/sax.h>
+#include <decoder/simd.h>
+#include <events.h>
+#include <executor.h>
+#include <fair_share.h>
+#include <fetcher.h>
+#include <graphql.h>
+#include <lanes.h>
+#include <link.h>
+#include <pacer.h>
+#include <priority.h>
+#include <retry.h>
+#include <search.h>
+#include <negative_cache.h>
+#include <single_flight.h>
+#include <tokens.h>
 
 #include <common.h>
 #include <config.h>
@@ -28,6 +41,8 @@ typedef struct ExtraData {
   std::string user;
   std::string repo;
   std::string branch;
+  int64_t depth = 0; // hops from the entry user to the entity of the path
+  double score = 0;  // priority the entity of the path was queued with, the entities found on it inherit it
 } ExtraData;
 
 typedef struct TrendingData {
@@ -44,6 +59,21 @@ typedef struct RequestConfig {
   std::string response_type;
 } RequestConfig;
 
+typedef struct PageCursor {
+  std::string host;   // origin of the next page
+  std::string next;   // path of the next page, empty on the last page
+  int64_t last = 0;   // number of the last page, 0 if unknown
+  int64_t total = -1; // total_count of a search page, -1 on the other lists
+  int64_t poll = 0;   // seconds the server asks to wait before the next poll, 0 if it does not say
+} PageCursor;
+
+typedef struct PageResult {
+  int code = 0;
+  PageCursor cursor;
+  std::vector<std::string> keys; // crawl version keys written by the page
+  enum request_type type_from;
+} PageResult;
+
 #define REQUEST_CONFIG(url) RequestConfig{ \
     .host = this->default_url_prefix,      \
     .path = request_url,                   \
@@ -53,20 +83,25 @@ class Request : public Application {
 private:
   Config config;
   Database *database;
-
-  int rate_limit_remaining{};
-  int rate_limit_limit{};
-  int rate_limit_reset{};
-
-  std::mutex request_locker;
-
-  unsigned long token_index = 0;
-
-  int semaphore = 0;
-  bool stopping = false;
-
-  // sleep for a while change another token if rate limit is reached
-  int sleep_for_another_token = 1000;
+  Decoder *decoder;
+
+  Fetcher *fetcher;
+  TokenScheduler *tokens;
+  NegativeCache *negatives;
+  RetryPolicy *retry;
+  Pacer *pacer;
+  FairShare *fair;
+  Executor *executor;
+  Lanes *lanes; // one for each token if token_lanes is set, the shared fetcher and pacer otherwise
+  std::map<std::string, PriorityFrontier *> frontiers; // crawl queue -> the keys waiting for it
+
+  std::string lease_owner; // replica holding the leases, empty if the leases are disabled
+  std::thread lease_thread;
+  std::thread info_thread;
+  std::thread events_thread;
+  std::thread search_thread;
+  int64_t last_event = 0; // id of the newest public event handled, stored by advance_events, only the events thread touches it
+  std::atomic<bool> stopping = false;
 
   std::string url_host = "api.github.com";
   std::string default_url_prefix = "https://" + url_host;
@@ -74,27 +109,67 @@ private:
   const std::string USERAGENT = "Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/93.0.4577.63 Safari/537.36";
   const std::string TIMEZONE = "Asia/Shanghai";
 
+  int startup_rate_limit();
+  int startup_frontier();
+  int startup_lease();
   int startup_followx();
   int startup_info();
+  int startup_profiles();
   int startup_emojis();
   int startup_orgs();
   int startup_gitignore();
   int startup_license();
   int startup_xrepos();
+  int startup_search();
+  int startup_events();
   int startup_repos_branches();
   int startup_repos_branches_commits();
 
-  int request_orgs_members(const nlohmann::json &content, enum request_type type_from);
-  int request_orgs(const nlohmann::json &content, enum request_type type_from);
-  int request_user(nlohmann::json content, enum request_type type_from);
-  int request_followx(const nlohmann::json &content, enum request_type type_from);
+  int request_orgs_members(const std::vector<User> &users, const ExtraData &extra, enum request_type type_from);
+  int request_orgs(const std::vector<Org> &orgs, const ExtraData &extra, enum request_type type_from);
+  int request_user(const User &user, const ExtraData &extra, enum request_type type_from);
+  int request_followx(const std::vector<User> &users, const ExtraData &extra, enum request_type type_from);
+  int request_users(const std::vector<User> &users, const ExtraData &extra, enum request_type type_from);
+  int hydrate(const std::vector<FrontierEntry> &entries);
+  int graphql_users(const std::vector<std::string> &logins, std::vector<User> &users, std::vector<std::string> &missing);
   int request_emoji(nlohmann::json content, enum request_type type_from);
   int request_gitignore_list(const nlohmann::json &content, enum request_type type_from);
   int request_gitignore_info(nlohmann::json content, enum request_type type_from);
   int request_license_list(const nlohmann::json &content, enum request_type type_from);
   int request_license_info(nlohmann::json content, enum request_type type_from);
-  int request_repo_list(nlohmann::json content, enum request_type type_from);
+  int request_repo_list(const std::vector<Repo> &repos, const ExtraData &extra, enum request_type type_from);
   int request_repo_branches(nlohmann::json content, ExtraData extra, enum request_type type_from);
+  int request_events(const nlohmann::json &content, const ExtraData &extra, enum request_type type_from);
+  int request_search(const RequestConfig &request_config, const std::string &body, enum request_type type, enum request_type type_from, PageCursor &cursor);
+
+  prometheus::Counter &graphql_users_counter = Metrics::counter("spider_users_hydrated_total", "User profiles fetched by the enrichment queue", {{"source", "graphql"}});
+  prometheus::Counter &rest_users_counter = Metrics::counter("spider_users_hydrated_total", "User profiles fetched by the enrichment queue", {{"source", "rest"}});
+  SingleFlight<PageResult> pages; // identical pages requested by several crawler threads at the same time
+  prometheus::Counter &coalesced_counter = Metrics::counter("spider_http_coalesced_total", "Requests served by an identical request in flight");
+  prometheus::Counter &search_split_counter = Metrics::counter("spider_search_splits_total", "Search ranges split for more results than the search api returns");
+  prometheus::Counter &events_counter = Metrics::counter("spider_events_total", "Public events turned into updates and re-crawls");
+  prometheus::Counter &not_modified_counter = Metrics::counter("spider_http_not_modified_total", "Conditional requests answered with 304");
+
+  void pause(int64_t milliseconds);
+  void crawl(const std::string &queue, std::function<std::vector<std::string>()> sample, std::function<bool(const std::string &, RequestConfig &)> build, enum request_type type);
+  void enrich();
+  void search(const SearchRange &all);
+  int search_range(const SearchRange &range, std::vector<SearchRange> &splits);
+  int claim(const std::string &queue, const std::vector<FrontierEntry> &entries, std::vector<FrontierEntry> &result);
+  void finish(const std::string &queue, const std::string &key);
+  void discover(const std::string &queue, const std::string &key, double score, int64_t depth);
+  void discover_user(const User &user, double score, int64_t depth);
+  void discover_org(const Org &org, double score, int64_t depth);
+  void revisit(const std::string &collection, const std::map<std::string, std::string> &changes);
+  FetchRequest prepare(const RequestConfig &request_config, int token);
+  int request_pages(const RequestConfig &request_config, const PageCursor &cursor, enum request_type type, enum request_type type_from);
+  int request_page(RequestConfig &request_config, enum request_type type, enum request_type type_from, bool skip_sleep, PageCursor &cursor);
+  int fetch_page(const RequestConfig &request_config, enum request_type type, enum request_type type_from, bool skip_sleep, PageResult &result);
+  int handle(const RequestConfig &request_config, const std::string &body, enum request_type type, enum request_type type_from, PageResult &result);
+  int parse(const RequestConfig &request_config, const std::string &body, nlohmann::json &content);
+  PageCursor page_cursor(const std::string &header_link);
+
+  void save_etag(const std::string &url, const FetchResponse &response, const std::string &link, std::vector<std::string> keys);
 
 public:
   Request(Config, Database *);
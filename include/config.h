@@ -1,4 +1,5 @@
 #include <iostream>
+#include <map>
 #include <regex>
 #include <string>
 #include <thread>
@@ -13,17 +14,54 @@
 
 #pragma once
 
+typedef struct ShareConfig {
+  double weight = 1;        // share of the requests under contention, relative to the other types
+  double min = 0;           // share of the requests guaranteed to the type, 0.2 is a fifth
+  int64_t max_per_hour = 0; // requests of the type in an hour at most, 0 is unlimited
+} ShareConfig;
+
 class Config {
 public:
   std::string database_type;
 
   std::string database_mongodb_dsn;
 
+  std::string json_backend = JSON_BACKEND_NLOHMANN; // decoder of the user, org and repo bodies
+
   std::string crawler_entry_username;       // entry username
   std::vector<std::string> crawler_token{}; // client id
+  int64_t crawler_token_reserve = DEFAULT_TOKEN_RESERVE; // budget kept of each token
+  int64_t crawler_token_chunk = DEFAULT_TOKEN_CHUNK;     // requests of the budget shared by the replicas reserved at once
   std::string crawler_useragent;            // useragent
   std::string crawler_timezone;             // timezone
-  int64_t crawler_sleep_each_request;       // sleep each request
+  int64_t crawler_sleep_each_request;       // the longest pause between two requests of the pacer
+
+  int64_t pool_max_connections = DEFAULT_POOL_MAX_CONNECTIONS; // keep-alive connections per host
+  int64_t pool_max_in_flight = DEFAULT_POOL_MAX_IN_FLIGHT;     // transfers running at the same time
+  int64_t pool_idle_timeout = DEFAULT_POOL_IDLE_TIMEOUT;       // close the idle connection after seconds
+  int64_t pool_timeout = DEFAULT_POOL_TIMEOUT;                 // timeout of each request in seconds
+
+  int64_t retry_max_attempts = DEFAULT_RETRY_MAX_ATTEMPTS;         // retries of a request
+  double retry_budget_ratio = DEFAULT_RETRY_BUDGET_RATIO;          // retries earned by each request
+  int64_t retry_breaker_failures = DEFAULT_RETRY_BREAKER_FAILURES; // consecutive 5xx or transport failures opening the breaker
+  int64_t retry_breaker_cooldown = DEFAULT_RETRY_BREAKER_COOLDOWN; // seconds the breaker stays open
+  int64_t retry_base_delay = DEFAULT_RETRY_BASE_DELAY;             // milliseconds the backoff of 5xx starts from
+  int64_t retry_max_delay = DEFAULT_RETRY_MAX_DELAY;               // milliseconds the backoff of 5xx grows to
+
+  int64_t crawler_pages_in_flight = DEFAULT_PAGES_IN_FLIGHT; // pages of one list fetched at the same time
+  int64_t crawler_workers = DEFAULT_WORKERS;                 // threads running the crawl tasks
+  bool crawler_token_lanes = false;                          // each token gets its own fetcher and pacer
+  int64_t crawler_share_slots = DEFAULT_SHARE_SLOTS;         // requests between the fair share and their response, for each lane
+  std::map<std::string, ShareConfig> crawler_shares;         // crawl type -> its share of the requests
+  std::string crawler_frontier_dir = DEFAULT_FRONTIER_DIR;   // directory of the frontier logs
+  int64_t crawler_frontier_max = DEFAULT_FRONTIER_MAX;       // keys waiting in the frontier of one crawl type
+  int64_t crawler_lease_ttl = DEFAULT_LEASE_TTL;             // seconds the keys of a batch are leased to this replica
+  int64_t crawler_lease_hold = DEFAULT_LEASE_HOLD;           // seconds a crawled key is kept from the other replicas
+  std::string crawler_hydration = HYDRATION_GRAPHQL;          // how the enrichment queue fetches the profiles
+  int64_t crawler_profile_ttl = DEFAULT_PROFILE_TTL;          // seconds a fetched profile is not fetched again
+  int64_t crawler_negative_ttl = DEFAULT_NEGATIVE_TTL;        // seconds a dead entity is skipped
+  int64_t crawler_revisit_min = DEFAULT_REVISIT_MIN;          // seconds between two visits of an entity at least
+  int64_t crawler_revisit_max = DEFAULT_REVISIT_MAX;          // seconds between two visits of an entity at most
 
   bool crawler_type_followers = false;
   bool crawler_type_followings = false;
@@ -36,6 +74,9 @@ public:
   bool crawler_type_emojis = false;
   bool crawler_type_gitignore_list = false;
   bool crawler_type_license_list = false;
+  bool crawler_type_search_users = false; // users found by the search api, on its own rate limit
+  bool crawler_type_search_repos = false; // repos found by the search api
+  bool crawler_type_events = false;       // public events polled for the repos and the users active lately
 
   int initialize(const std::string &config_path);
 
@@ -4,7 +4,60 @@
 
 const std::string DATABASE_MONGODB = "mongodb";
 
+const std::string JSON_BACKEND_NLOHMANN = "nlohmann";
+const std::string JSON_BACKEND_SIMDJSON = "simdjson";
+
+const std::string HYDRATION_GRAPHQL = "graphql";
+const std::string HYDRATION_REST = "rest";
+
 const int DEFAULT_SLEEP_EACH_REQUEST = 1000;
 
+const size_t GRAPHQL_MAX_NODES = 100;     // aliased user lookups in one query
+const int GRAPHQL_RATE_LIMIT_PAUSE = 60; // seconds a token out of graphql points waits if its reset is unknown
+
+const std::string PROFILES_QUEUE = "profiles"; // the enrichment queue of the users found on the list pages
+const int DEFAULT_PROFILE_TTL = 7 * 24 * 3600; // seconds a fetched profile is fresh
+const double DEFAULT_PROFILES_WEIGHT = 0.25;   // share of the enrichment under contention, it takes the spare budget
+
+const int DEFAULT_PAGES_IN_FLIGHT = 4; // pages of one list fetched at the same time
+
+const int DEFAULT_WORKERS = 16; // threads of the crawl executor
+
+const int DEFAULT_SHARE_SLOTS = 4; // requests of the crawl types arbitrated at the same time
+
+const std::string DEFAULT_FRONTIER_DIR = "frontier";
+const int DEFAULT_FRONTIER_MAX = 1000000; // keys waiting in the frontier of one crawl type
+const size_t FRONTIER_BATCH = 100;         // keys popped for one batch of a crawl type
+const int CRAWL_IDLE_PAUSE = 60;           // seconds a crawl type waits if its frontier and its sample are empty
+
+const int DEFAULT_LEASE_TTL = 0;     // seconds a replica holds the keys of a batch, 0 disables the leases
+const int DEFAULT_LEASE_HOLD = 3600; // seconds a crawled key is kept from the other replicas
+
+const int PRIORITY_BANDS = 4;
+const double PRIORITY_DEPTH_PENALTY = 0.5; // score lost for each hop from the entry user
+const int PRIORITY_SAMPLED_DEPTH = 3;      // hops assumed for an entity sampled from the database
+const double PRIORITY_SAMPLED_SCORE = 1.5; // score assumed for it, the sample is cut to its most valuable part
+const int PRIORITY_SAMPLE_FACTOR = 10;     // the database sample is this much larger and cut to its most valuable part
+
+const int DEFAULT_NEGATIVE_TTL = 7 * 24 * 3600; // seconds a 404, 410 or 451 entity is skipped
+
+const int DEFAULT_REVISIT_MIN = 3600;            // seconds a user or a repo is not visited again at least
+const int DEFAULT_REVISIT_MAX = 30 * 24 * 3600; // seconds a user or a repo waits at most, 0 disables the revisit scheduler
+
+const int DEFAULT_TOKEN_RESERVE = 50; // stop using a token before its budget runs out
+const int DEFAULT_TOKEN_CHUNK = 0;    // requests of the shared budget reserved at once, 0 if the tokens are not shared
+
+const int DEFAULT_RETRY_MAX_ATTEMPTS = 4;
+const double DEFAULT_RETRY_BUDGET_RATIO = 0.1; // retries allowed for each request
+const int DEFAULT_RETRY_BREAKER_FAILURES = 5;  // consecutive failures opening the breaker of an endpoint
+const int DEFAULT_RETRY_BREAKER_COOLDOWN = 30; // seconds
+const int DEFAULT_RETRY_BASE_DELAY = 1000;     // milliseconds of the first retry of a 5xx
+const int DEFAULT_RETRY_MAX_DELAY = 60000;     // milliseconds
+
+const int DEFAULT_POOL_MAX_CONNECTIONS = 8;
+const int DEFAULT_POOL_MAX_IN_FLIGHT = 16;
+const int DEFAULT_POOL_IDLE_TIMEOUT = 60; // seconds
+const int DEFAULT_POOL_TIMEOUT = 30;      // seconds
+
 const std::string KEYS_DELIMITER = ";";
 const std::string VALUE_DELIMITER = ":";
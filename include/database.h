@@ -1,4 +1,5 @@
 #include <iostream>
+#include <map>
 
 #include <model.h>
 
@@ -21,6 +22,13 @@ public:
   virtual std::vector<std::string> list_users_random(enum request_type type) = 0;
 
   virtual std::vector<User> list_usersx(common_args args) = 0;
+  // upsert_user_stub writes the fields of a list page only, the profile of a known user is kept
+  virtual int upsert_user_stub(const std::vector<User> &users) = 0;
+  // list_users_fresh returns the users whose profile was fetched in the last ttl seconds, the login, the
+  // followers and the public repos of them only
+  virtual std::vector<User> list_users_fresh(const std::vector<std::string> &logins, int64_t ttl) = 0;
+  virtual std::vector<std::string> list_users_stale(int64_t ttl) = 0;
+  virtual int touch_users(const std::vector<std::string> &ids) = 0;
 
   virtual int upsert_org(Org org) = 0;
   virtual int upsert_org(std::vector<Org> orgs) = 0;
@@ -43,6 +51,14 @@ public:
   virtual int upsert_repo(std::vector<Repo> repos) = 0;
   virtual int upsert_repo_with_version(Repo repo, enum request_type type) = 0;
   virtual int upsert_repo_with_version(std::vector<Repo> repos, enum request_type type) = 0;
+  // touch_repos applies the activity of the events to the known repos, the unknown ones are left to the crawl
+  virtual int touch_repos(const std::vector<RepoActivity> &repos) = 0;
+  // advance_events moves the id of the newest public event handled up to last, the id stored before is returned,
+  // 0 if none is stored yet and -1 on error. The events up to the id returned were handled by another replica.
+  virtual int64_t advance_events(int64_t last) = 0;
+  // observe_revisits folds a visit into the change history of the entities and schedules the next one,
+  // changes maps the key of an entity to the updated_at or pushed_at the visit saw
+  virtual int observe_revisits(const std::string &collection, const std::map<std::string, std::string> &changes, int64_t min, int64_t max) = 0;
   virtual std::vector<std::string> list_repos_random(enum request_type type) = 0;
   virtual int64_t count_repo() = 0;
 
@@ -56,4 +72,20 @@ public:
   virtual int upsert_commit(std::vector<Commit> commits) = 0;
   virtual int upsert_commit_with_version(Commit commit, enum request_type type) = 0;
   virtual int upsert_commit_with_version(std::vector<Commit> commits, enum request_type type) = 0;
+
+  virtual int upsert_etag(Etag etag) = 0;
+  virtual Etag get_etag(std::string url) = 0;
+
+  virtual int upsert_negative(Negative negative) = 0;
+  virtual std::vector<Negative> list_negatives() = 0;
+
+  // claim_leases leases the keys of the crawl type to the owner for ttl seconds, claimed gets the keys it holds
+  virtual int claim_leases(const std::string &queue, const std::vector<std::string> &keys, const std::string &owner, int64_t ttl, std::vector<std::string> &claimed) = 0;
+  virtual int renew_leases(const std::string &owner, int64_t ttl) = 0;
+  // finish_lease keeps the crawled key from the other replicas for hold seconds
+  virtual int finish_lease(const std::string &queue, const std::string &key, const std::string &owner, int64_t hold) = 0;
+  virtual int release_leases(const std::string &owner) = 0;
+
+  // reserve_token_budget takes up to chunk of the cap requests of the token in the window, the requests granted are returned
+  virtual int64_t reserve_token_budget(const std::string &token, const std::string &resource, int64_t window, int64_t cap, int64_t chunk) = 0;
 };
@@ -1,6 +1,8 @@
+#include <algorithm>
 #include <iostream>
 #include <map>
 #include <random>
+#include <set>
 #include <thread>
 #include <utility>
 
@@ -12,6 +14,7 @@
 #include <fmt/core.h>
 #include <mongocxx/client.hpp>
 #include <mongocxx/database.hpp>
+#include <mongocxx/exception/bulk_write_exception.hpp>
 #include <mongocxx/instance.hpp>
 #include <mongocxx/pool.hpp>
 #include <mongocxx/stdx.hpp>
@@ -21,6 +24,7 @@
 #include <common.h>
 #include <const.h>
 #include <error.h>
+#include <revisit.h>
 #include <versions.h>
 
 #pragma once
@@ -49,6 +53,10 @@ private:
 
   const int32_t sample_size = 100;
 
+  static bsoncxx::document::value lookup_keyed(const std::string &from, const std::string &collection, const std::string &local, const std::string &as);
+  std::map<std::string, int64_t> due_revisits(const std::string &collection, int64_t limit);
+  int pass_version(const std::vector<std::string> &keys, enum request_type type, bool visited);
+
 public:
   explicit Mongo(const std::string &);
   ~Mongo() override;
@@ -59,8 +67,10 @@ public:
   int insert_x(const std::string &collection, bsoncxx::document::view_or_value doc);
   int upsert_x(const std::string &collection, std::string filter, std::string update);
   int upsert_x(const std::string &collection, const std::map<std::string, std::string> &filters);
-  std::vector<std::string> list_x_random(const std::string &collection, std::string key, enum request_type type);
-  int ensure_index(const std::string &collection, std::vector<std::string> index);
+  std::vector<std::string> list_x_random(const std::string &collection, std::string key, enum request_type type, const std::string &negative_key = "", const std::string &sort_key = "");
+  // ensure_index creates the index of the keys, unique unless a plain index for the queries is asked for
+  int ensure_index(const std::string &collection, std::vector<std::string> index, bool unique = true);
+  int ensure_ttl_index(const std::string &collection, const std::string &key);
   int create_x_collection(const std::string &collection, std::string key);
 
   int create_collections();
@@ -74,6 +84,10 @@ public:
   int64_t count_user() override;
   std::vector<std::string> list_users_random(enum request_type type) override;
   std::vector<User> list_usersx(common_args args) override;
+  int upsert_user_stub(const std::vector<User> &users) override;
+  std::vector<User> list_users_fresh(const std::vector<std::string> &logins, int64_t ttl) override;
+  std::vector<std::string> list_users_stale(int64_t ttl) override;
+  int touch_users(const std::vector<std::string> &ids) override;
 
   int upsert_org(Org org) override;
   int upsert_org(std::vector<Org> orgs) override;
@@ -97,6 +111,11 @@ public:
   int upsert_repo(std::vector<Repo> repos) override;
   int upsert_repo_with_version(Repo repo, enum request_type type) override;
   int upsert_repo_with_version(std::vector<Repo> repos, enum request_type type) override;
+  int touch_repos(const std::vector<RepoActivity> &repos) override;
+  int64_t advance_events(int64_t last) override;
+  // get_repo reads a stored repo, the repo is left empty if it is not stored
+  Repo get_repo(const std::string &owner, const std::string &name);
+  int observe_revisits(const std::string &collection, const std::map<std::string, std::string> &changes, int64_t min, int64_t max) override;
   std::vector<std::string> list_repos_random(enum request_type type) override;
   int64_t count_repo() override;
 
@@ -112,4 +131,17 @@ public:
   int upsert_commit(std::vector<Commit> commits) override;
   int upsert_commit_with_version(Commit commit, enum request_type type) override;
   int upsert_commit_with_version(std::vector<Commit> commits, enum request_type type) override;
+
+  int upsert_etag(Etag etag) override;
+  Etag get_etag(std::string url) override;
+
+  int upsert_negative(Negative negative) override;
+  std::vector<Negative> list_negatives() override;
+
+  int claim_leases(const std::string &queue, const std::vector<std::string> &keys, const std::string &owner, int64_t ttl, std::vector<std::string> &claimed) override;
+  int renew_leases(const std::string &owner, int64_t ttl) override;
+  int finish_lease(const std::string &queue, const std::string &key, const std::string &owner, int64_t hold) override;
+  int release_leases(const std::string &owner) override;
+
+  int64_t reserve_token_budget(const std::string &token, const std::string &resource, int64_t window, int64_t cap, int64_t chunk) override;
 };
@@ -0,0 +1,25 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <model.h>
+
+#pragma once
+
+// Decoder fills the model structs straight from the response body, the fields not in the models are skipped
+class Decoder {
+public:
+  virtual ~Decoder() = default;
+
+  // /users/{login}
+  virtual int decode_user(const std::string &body, User &user) = 0;
+  // the user lists, such as followers and org members, only have login, id, node_id and type
+  virtual int decode_users(const std::string &body, std::vector<User> &users) = 0;
+  // /users/{login}/repos and /orgs/{org}/repos
+  virtual int decode_repos(const std::string &body, std::vector<Repo> &repos) = 0;
+  // /users/{login}/orgs
+  virtual int decode_orgs(const std::string &body, std::vector<Org> &orgs) = 0;
+  // /search/users and /search/repositories, the items of the page with its total_count and incomplete_results
+  virtual int decode_search_users(const std::string &body, std::vector<User> &users, int64_t &total, bool &incomplete) = 0;
+  virtual int decode_search_repos(const std::string &body, std::vector<Repo> &repos, int64_t &total, bool &incomplete) = 0;
+};
@@ -0,0 +1,150 @@
+#include <array>
+#include <iostream>
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <common.h>
+#include <decoder.h>
+#include <error.h>
+
+#pragma once
+
+// ModelSax receives the nlohmann SAX events of a body and hands the scalar values of the model
+// objects to the setters with their key and the key of their parent object, e.g. owner.login of a repo.
+// No DOM node is built, the keys of no interest are dropped while tokenizing.
+template <class T>
+class ModelSax : public nlohmann::json::json_sax_t {
+private:
+  static const int max_depth = 16;
+
+  std::vector<T> &items;
+  int item_depth; // 1 if the body is one model object, 2 if it is an array of them, 3 if a search page wraps them
+  int depth = 0;
+  std::array<std::string, max_depth> keys;
+  std::array<bool, max_depth> objects{};
+
+  // the models of a search page are the objects of its items array only
+  bool wrapped() const { return item_depth != 3 || keys[1] == "items"; }
+
+  T *item(std::string_view &parent, std::string_view &key) {
+    if (!this->wrapped()) {
+      return nullptr;
+    }
+    if (depth == item_depth && objects[depth]) {
+      parent = "";
+      key = keys[depth];
+      return &items.back();
+    }
+    if (depth == item_depth + 1 && objects[depth]) {
+      parent = keys[item_depth];
+      key = keys[depth];
+      return &items.back();
+    }
+    return nullptr;
+  }
+
+  bool open(bool object) {
+    depth++;
+    if (depth >= max_depth) {
+      return true; // too deep to be a model field, only tracked by the depth
+    }
+    objects[depth] = object;
+    keys[depth].clear();
+    if (depth == 1 && object != (item_depth != 2)) {
+      error = "unexpected json root";
+      return false;
+    }
+    if (object && depth == item_depth && this->wrapped()) {
+      items.emplace_back();
+    }
+    return true;
+  }
+
+protected:
+  virtual void set(T &item, std::string_view parent, std::string_view key, const std::string &value) {}
+  virtual void set(T &item, std::string_view parent, std::string_view key, int64_t value) {}
+  virtual void set(T &item, std::string_view parent, std::string_view key, bool value) {}
+
+public:
+  std::string error;
+  int64_t total = -1;      // total_count of a search page
+  bool incomplete = false; // incomplete_results of a search page
+
+  ModelSax(std::vector<T> &items, int item_depth) : items(items), item_depth(item_depth) {}
+
+  // null leaves the value initialized field as it is, the same as the empty string or 0
+  bool null() override { return true; }
+
+  bool boolean(bool val) override {
+    if (item_depth == 3 && depth == 1 && keys[1] == "incomplete_results") {
+      incomplete = val;
+    }
+    std::string_view parent, key;
+    if (T *it = this->item(parent, key)) {
+      this->set(*it, parent, key, val);
+    }
+    return true;
+  }
+
+  bool number_integer(number_integer_t val) override {
+    if (item_depth == 3 && depth == 1 && keys[1] == "total_count") {
+      total = static_cast<int64_t>(val);
+    }
+    std::string_view parent, key;
+    if (T *it = this->item(parent, key)) {
+      this->set(*it, parent, key, static_cast<int64_t>(val));
+    }
+    return true;
+  }
+
+  bool number_unsigned(number_unsigned_t val) override { return this->number_integer(static_cast<number_integer_t>(val)); }
+
+  bool number_float(number_float_t, const string_t &) override { return true; }
+
+  bool string(string_t &val) override {
+    std::string_view parent, key;
+    if (T *it = this->item(parent, key)) {
+      this->set(*it, parent, key, val);
+    }
+    return true;
+  }
+
+  bool binary(binary_t &) override { return true; }
+
+  bool start_object(std::size_t) override { return this->open(true); }
+
+  bool key(string_t &val) override {
+    if (depth < max_depth) {
+      keys[depth] = val;
+    }
+    return true;
+  }
+
+  bool end_object() override {
+    depth--;
+    return true;
+  }
+
+  bool start_array(std::size_t) override { return this->open(false); }
+
+  bool end_array() override {
+    depth--;
+    return true;
+  }
+
+  bool parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &ex) override {
+    error = ex.what();
+    return false;
+  }
+};
+
+class SaxDecoder : public Decoder {
+public:
+  int decode_user(const std::string &body, User &user) override;
+  int decode_users(const std::string &body, std::vector<User> &users) override;
+  int decode_repos(const std::string &body, std::vector<Repo> &repos) override;
+  int decode_orgs(const std::string &body, std::vector<Org> &orgs) override;
+  int decode_search_users(const std::string &body, std::vector<User> &users, int64_t &total, bool &incomplete) override;
+  int decode_search_repos(const std::string &body, std::vector<Repo> &repos, int64_t &total, bool &incomplete) override;
+};
@@ -0,0 +1,22 @@
+#include <iostream>
+
+#include <simdjson.h>
+#include <spdlog/spdlog.h>
+
+#include <common.h>
+#include <decoder.h>
+#include <error.h>
+
+#pragma once
+
+// SimdDecoder walks the body with the simdjson on-demand api, only the fields of the models are materialized.
+// Every thread keeps its own parser, the decoder is shared by the crawler threads.
+class SimdDecoder : public Decoder {
+public:
+  int decode_user(const std::string &body, User &user) override;
+  int decode_users(const std::string &body, std::vector<User> &users) override;
+  int decode_repos(const std::string &body, std::vector<Repo> &repos) override;
+  int decode_orgs(const std::string &body, std::vector<Org> &orgs) override;
+  int decode_search_users(const std::string &body, std::vector<User> &users, int64_t &total, bool &incomplete) override;
+  int decode_search_repos(const std::string &body, std::vector<Repo> &repos, int64_t &total, bool &incomplete) override;
+};
@@ -7,3 +7,8 @@ const int DATABASE_OPEN_ERROR = -3;
 const int CONFIG_PARSE_ERROR = -4;
 const int SQL_EXEC_ERROR = -5;
 const int DATABASE_SQL_ERROR = -6;
+const int JSON_PARSE_ERROR = -7;
+const int CIRCUIT_OPEN = -8;
+const int FRONTIER_ERROR = -9;
+const int LEASE_ERROR = -10;
+const int RATE_LIMITED_ERROR = -11;
@@ -0,0 +1,28 @@
+#include <iostream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <const.h>
+#include <model.h>
+
+#pragma once
+
+const std::string EVENTS_PATH = "/events?per_page=100";
+const int64_t EVENTS_POLL_INTERVAL = 60; // seconds between two polls if the server sends no X-Poll-Interval
+
+// EventActions is what a page of the public events asks of the crawler, the repos are updated in place,
+// the rest is queued to the crawl types that fetch it again
+typedef struct EventActions {
+  int64_t last = 0;  // id of the newest event of the page
+  int64_t count = 0; // events newer than the ones seen before
+  std::vector<User> users; // actors and added members, once each
+  std::vector<RepoActivity> repos;
+  std::set<std::pair<std::string, std::string>> recrawls; // crawl queue and key
+} EventActions;
+
+// event_actions reads the events with an id above after, a malformed event is skipped
+EventActions event_actions(const nlohmann::json &events, int64_t after);
@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <metrics.h>
+
+#pragma once
+
+typedef struct Task {
+  std::string queue; // the crawl type of the task, the depth of the queues is exposed per name
+  std::function<void()> run;
+} Task;
+
+// FanOut is the latch of one fan-out, a job index is claimed by the caller or by one of the tasks
+typedef struct FanOut {
+  std::mutex locker;
+  std::condition_variable finished;
+  size_t next = 0; // the first job not claimed yet
+  size_t count = 0;
+  size_t left = 0; // the jobs not finished yet
+  int code = 0;
+  std::function<int(size_t)> job;
+} FanOut;
+
+typedef struct Worker {
+  std::mutex locker;
+  std::deque<Task> tasks;
+} Worker;
+
+// Executor runs the crawl tasks on a fixed number of workers. Each worker has its own deque, the tasks
+// submitted by a worker go to the back of its deque and are taken from the back again, an idle worker
+// steals from the front of the others, so a page fan-out stays close to the thread that started it.
+class Executor {
+private:
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::vector<std::thread> threads;
+  std::atomic<size_t> next = 0; // the deque of the next task submitted from outside of the workers
+
+  std::mutex locker;
+  std::condition_variable changed;
+  int64_t pending = 0;
+  bool stopping = false;
+
+  std::mutex depth_locker;
+  std::map<std::string, int64_t> depths;
+
+  void loop(size_t index);
+  bool take(size_t index, Task &task);
+  void depth(const std::string &queue, int64_t delta);
+
+public:
+  explicit Executor(int64_t workers);
+  ~Executor();
+
+  void submit(const std::string &queue, std::function<void()> run);
+  // fan_out runs job(0) to job(count - 1) on the idle workers and on the calling thread, which runs the
+  // jobs of this fan-out only and never another task, the first error of the jobs is returned
+  int fan_out(const std::string &queue, size_t count, const std::function<int(size_t)> &job);
+  // stop drops the tasks not started yet and joins the workers
+  void stop();
+
+  int64_t depth(const std::string &queue);
+  size_t size() const;
+};
@@ -0,0 +1,69 @@
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <list>
+#include <map>
+#include <mutex>
+
+#include <config.h>
+#include <metrics.h>
+#include <model.h>
+
+#pragma once
+
+// FairShare arbitrates the requests of the crawl types. A request takes one of the slots before it is
+// paced and sent, and gives it back with the response. A free slot goes to the waiting type below its
+// minimum share first, then to the one with the earliest start tag of a weighted fair queue, so each
+// type gets its weight of the requests under contention. A type over its hourly cap waits without a slot.
+class FairShare {
+private:
+  typedef struct Category {
+    ShareConfig config;
+    double finish = 0; // the finish tag of the latest request queued
+    double share = 0;  // moving share of the slots granted
+    std::deque<std::chrono::steady_clock::time_point> hour;
+    prometheus::Counter *requests;
+    prometheus::Gauge *hour_gauge;
+    prometheus::Gauge *share_gauge;
+  } Category;
+
+  typedef struct Waiter {
+    std::string category;
+    double start;
+    uint64_t ticket;
+  } Waiter;
+
+  int64_t slots;
+  int64_t in_use = 0;
+  double vtime = 0;
+  uint64_t tickets = 0;
+  bool stopping = false;
+
+  std::mutex locker;
+  std::condition_variable changed;
+  std::map<std::string, ShareConfig> shares;
+  std::map<std::string, Category> categories;
+  std::list<Waiter> waiters;
+  prometheus::Gauge &waiting_gauge;
+
+  Category &get(const std::string &name);
+  bool capped(Category &category, std::chrono::steady_clock::time_point now);
+  const Waiter *next(std::chrono::steady_clock::time_point now);
+
+public:
+  FairShare(int64_t slots, std::map<std::string, ShareConfig> shares);
+
+  // acquire blocks until the type gets a slot, returns false if the scheduler is stopping
+  bool acquire(const std::string &category);
+  void release();
+  void stop();
+
+  double share(const std::string &category);
+  // waiting returns the requests waiting for a slot
+  size_t waiting();
+  // category names the crawl type a request is charged to
+  static std::string category(enum request_type type);
+  // known returns true if a request may be charged to the category, a share of another name is never used
+  static bool known(const std::string &category);
+};
@@ -0,0 +1,103 @@
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <boost/algorithm/string.hpp>
+#include <curl/curl.h>
+#include <spdlog/spdlog.h>
+
+#include <metrics.h>
+
+#pragma once
+
+// header names are case insensitive, HTTP/2 sends all of them in lower case
+struct HeaderLess {
+  bool operator()(const std::string &a, const std::string &b) const {
+    return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), [](unsigned char x, unsigned char y) {
+      return std::tolower(x) < std::tolower(y);
+    });
+  }
+};
+
+typedef std::multimap<std::string, std::string, HeaderLess> Headers;
+
+typedef struct FetchRequest {
+  std::string method = "GET";
+  std::string url; // full url with scheme and host
+  Headers headers;
+  std::string body;
+  int64_t timeout = 0; // milliseconds, 0 means the fetcher default
+} FetchRequest;
+
+typedef struct FetchResponse {
+  int status = 0;    // 0 means the transfer failed, see error
+  std::string error; // transfer error message
+  Headers headers;
+  std::string body;
+  bool reused = false; // the transfer went over a reused connection
+} FetchResponse;
+
+typedef std::function<void(FetchResponse)> FetchCallback;
+
+// Fetcher is an event driven http engine over libcurl multi. All of the transfers are driven by
+// one thread, keep up to max_in_flight of them running and multiplex them over HTTP/2 connections,
+// connections and TLS sessions are reused across the transfers. The bodies are requested with
+// gzip or deflate and libcurl decodes them while they stream in.
+class Fetcher {
+private:
+  typedef struct Transfer {
+    CURL *easy = nullptr;
+    curl_slist *headers = nullptr;
+    FetchRequest request;
+    FetchResponse response;
+    FetchCallback callback;
+  } Transfer;
+
+  size_t max_in_flight;
+  int64_t max_host_connections;
+  int64_t idle_timeout; // seconds
+  int64_t timeout;      // milliseconds
+
+  CURLM *multi = nullptr;
+  CURLSH *share = nullptr;
+
+  std::mutex locker;
+  std::deque<Transfer *> pending;
+  std::set<Transfer *> running; // only touched by the loop thread
+  std::atomic<bool> stopping = false;
+  std::thread loop_thread;
+
+  prometheus::Counter &created_counter;
+  prometheus::Counter &reused_counter;
+  prometheus::Gauge &in_flight_gauge;
+  prometheus::Counter &wire_bytes_counter;
+  prometheus::Counter &decoded_bytes_counter;
+
+  void loop();
+  void start(Transfer *transfer);
+  void finish(CURL *easy, CURLcode code);
+
+  static size_t on_body(char *ptr, size_t size, size_t nmemb, void *userdata);
+  static size_t on_header(char *ptr, size_t size, size_t nmemb, void *userdata);
+
+public:
+  // labels tell the gauges of several fetchers apart, the counters are summed over them
+  Fetcher(size_t max_in_flight, int64_t max_host_connections, int64_t idle_timeout, int64_t timeout, const prometheus::Labels &labels = {});
+  ~Fetcher();
+
+  // callback is invoked on the fetcher thread, it must not block
+  void submit(FetchRequest request, FetchCallback callback);
+  std::future<FetchResponse> submit(FetchRequest request);
+
+  double created() { return created_counter.Value(); }
+  double reused() { return reused_counter.Value(); }
+  double wire_bytes() { return wire_bytes_counter.Value(); }
+  double decoded_bytes() { return decoded_bytes_counter.Value(); }
+};
@@ -0,0 +1,92 @@
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <error.h>
+#include <metrics.h>
+
+#pragma once
+
+typedef struct FrontierHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t head; // offset of the first record not committed yet
+} FrontierHeader;
+
+typedef struct FrontierRecord {
+  uint32_t size;  // bytes of the key following the record, 0 marks the end of the log
+  uint32_t crc;   // crc32 of the depth, the score and the key, a torn record of a crash does not match it
+  uint32_t depth; // hops from the entry user the entity was found at
+  float score;    // priority the entity was pushed with
+} FrontierRecord;
+
+typedef struct FrontierEntry {
+  std::string key;
+  int64_t depth = 0;
+  double score = 0;
+  int band = 0; // the priority band the entry was popped from
+} FrontierEntry;
+
+// Frontier is the queue of the entity keys waiting to be crawled for one crawl type. It is an append-only
+// log mapped into memory, the pushed keys are in the page cache at once and survive a crash of the process,
+// commit flushes them with the head to the disk. The keys popped but not committed yet are popped again
+// after a restart, so a batch cut by a shutdown is not lost. A popped key is not pushed again for window
+// seconds, the pages crawling it link back to it over and over; the visits are kept in memory only.
+class Frontier {
+private:
+  std::string name;
+  std::string path;
+  size_t max;     // pending keys at most, the pushes over it are dropped
+  int64_t window; // seconds a popped key is not pushed again, 0 disables it
+
+  std::mutex locker;
+  int fd = -1;
+  char *data = nullptr;
+  size_t capacity = 0;
+  uint64_t head = 0; // the next record to pop
+  uint64_t tail = 0; // the end of the last record
+  std::unordered_set<std::string> pending;
+  std::unordered_map<std::string, int64_t> visited; // key -> last pop
+  std::deque<std::pair<int64_t, std::string>> pops; // the pops in order, visited expires by them
+
+  prometheus::Gauge &size_gauge;
+  prometheus::Counter &pushed_counter;
+
+  int map(size_t size);
+  int compact();
+  int upgrade();
+  FrontierHeader *header();
+  bool recent(const std::string &key, int64_t now);
+
+public:
+  Frontier(const std::string &dir, const std::string &name, size_t max, int64_t window = 0);
+  ~Frontier();
+
+  // open maps the log, creates it if missing and reloads the keys after the committed head, a log of
+  // version 2 is rewritten with a score of 0 for its records first
+  int open();
+  // legacy reads the pending keys of a log of version 1, the records had no depth then
+  static int legacy(const std::string &path, std::vector<std::string> &keys);
+  // push appends the key, a key already pending or seen, or a full frontier is skipped and returns false
+  bool push(const std::string &key, int64_t depth = 0, double score = 0);
+  std::vector<FrontierEntry> pop(size_t count);
+  // requeue pushes a popped key again, the key is not skipped as seen
+  bool requeue(const std::string &key, int64_t depth, double score);
+  // remove drops a pending key, its record is skipped by pop. Returns false if the key is not pending.
+  bool remove(const std::string &key);
+  // commit makes the pops so far durable, the log is rewritten once most of it is consumed
+  int commit();
+
+  bool contains(const std::string &key);
+  // seen returns true if the key is pending or was popped less than window seconds ago
+  bool seen(const std::string &key);
+  size_t size();
+};
@@ -0,0 +1,23 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <const.h>
+#include <error.h>
+#include <model.h>
+
+#pragma once
+
+const std::string GRAPHQL_RATE_LIMITED = "RATE_LIMITED"; // type of the error when the points of the token are spent
+
+// graphql_users_query looks up the logins with one aliased query, u0 to u<n-1>
+std::string graphql_users_query(const std::vector<std::string> &logins);
+
+// graphql_users_parse reads the users of the query, missing gets the logins GraphQL does not resolve to
+// a User, such as bots. RATE_LIMITED_ERROR is returned if the token is out of points, REQUEST_ERROR if
+// the response has no data at all
+int graphql_users_parse(const std::string &body, const std::vector<std::string> &logins, std::vector<User> &users, std::vector<std::string> &missing);
@@ -0,0 +1,36 @@
+#include <iostream>
+#include <vector>
+
+#include <fetcher.h>
+#include <pacer.h>
+#include <tokens.h>
+
+#pragma once
+
+// Lane is the fetcher and the pacer of one token in the token lanes mode
+typedef struct Lane {
+  Fetcher *fetcher;
+  Pacer *pacer;
+} Lane;
+
+// Lanes hands a request the fetcher and the pacer of the token it got. In the token lanes mode each token
+// has a lane of its own, paced by the budget of the token, the tokens share one lane paced by the budget
+// of all of them otherwise.
+class Lanes {
+private:
+  TokenScheduler *tokens;
+  Lane shared;
+  std::vector<Lane> lanes; // indexed by the token, empty if the tokens share the lane
+
+public:
+  // the lanes of the tokens are deleted with Lanes, the shared one belongs to the caller
+  Lanes(TokenScheduler *tokens, Lane shared, std::vector<Lane> lanes);
+  ~Lanes();
+
+  // split returns true if each token has its own lane, the request is paced after its token is picked then
+  bool split();
+  Lane lane(int token);
+  // reserve takes the next slot of the lane of the token at the rate of its budget and returns the
+  // milliseconds to wait for it, a token below 0 reserves in the shared lane at the rate of all of them
+  int64_t reserve(int token);
+};
@@ -0,0 +1,27 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#pragma once
+
+// LinkHeader holds the urls of a Link header, they are views into the parsed header
+typedef struct LinkHeader {
+  std::string_view next;
+  std::string_view last;
+  std::string_view prev;
+  std::string_view first;
+} LinkHeader;
+
+// parse_link parses `<https://api.github.com/user/1/followers?page=2>; rel="next", <...>; rel="last"`
+// in one pass without allocation, any host is accepted
+LinkHeader parse_link(std::string_view header);
+
+// split_url splits `https://api.github.com/users?page=2` into `https://api.github.com` and `/users?page=2`
+void split_url(std::string_view url, std::string_view &origin, std::string_view &path);
+
+// link_page returns the value of the page query parameter, 0 if there is none
+int64_t link_page(std::string_view url);
+
+// link_with_page returns the url with its page query parameter set to page
+std::string link_with_page(std::string_view url, int64_t page);
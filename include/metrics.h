@@ -0,0 +1,25 @@
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <prometheus/counter.h>
+#include <prometheus/gauge.h>
+#include <prometheus/registry.h>
+
+#pragma once
+
+// Metrics is the process wide prometheus registry, every component registers its own counters here
+// and the Prome application exposes them.
+class Metrics {
+public:
+  static std::shared_ptr<prometheus::Registry> registry();
+
+  static prometheus::Counter &counter(const std::string &name, const std::string &help, const prometheus::Labels &labels = {});
+  static prometheus::Gauge &gauge(const std::string &name, const std::string &help, const prometheus::Labels &labels = {});
+
+private:
+  static std::mutex locker;
+  static std::map<std::string, prometheus::Family<prometheus::Counter> *> counters;
+  static std::map<std::string, prometheus::Family<prometheus::Gauge> *> gauges;
+};
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <vector>
 
 #pragma once
 
@@ -17,6 +18,9 @@ enum request_type {
   request_type_gitignore_info,
   request_type_license_list,
   request_type_license_info,
+  request_type_search_users,
+  request_type_search_repos,
+  request_type_events,
 };
 
 typedef struct {
@@ -102,6 +106,15 @@ typedef struct Repo {
   std::string default_branch;
 } Repo;
 
+// RepoActivity is what an event tells of a known repo, it is applied without fetching the repo
+typedef struct RepoActivity {
+  std::string owner;
+  std::string name;
+  std::string pushed_at; // empty if the event is not a push
+  int64_t stars = 0;     // stars added since the repo was crawled
+  int64_t forks = 0;     // forks added since the repo was crawled
+} RepoActivity;
+
 typedef struct Branch {
   std::string owner;
   std::string repo;
@@ -109,6 +122,22 @@ typedef struct Branch {
   std::string commit;
 } Branch;
 
+typedef struct Etag {
+  std::string url;
+  std::string etag;
+  std::string last_modified;
+  std::string link;              // Link header of the page, the pagination goes on after a 304
+  std::vector<std::string> keys; // version keys written by the page
+} Etag;
+
+typedef struct Negative {
+  std::string collection; // users, orgs or repos, empty if the url belongs to no entity
+  std::string key;        // login, owner/repo or the url
+  std::string url;        // url answered with the status
+  int status;             // 404, 410 or 451
+  int64_t expire_at;      // unix seconds
+} Negative;
+
 typedef struct Trending {
   std::string seq;
   std::string spoken_language;
@@ -0,0 +1,40 @@
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <mutex>
+
+#include <metrics.h>
+#include <model.h>
+
+#pragma once
+
+// NegativeCache keeps the entities answered with 404, 410 or 451 until their expire time, so the
+// crawler stops spending budget on deleted users and repos. It mirrors the negatives collection.
+class NegativeCache {
+private:
+  std::mutex locker;
+  std::map<std::string, Negative> entries; // collection:key -> negative
+
+  prometheus::Counter &hits_counter;
+  prometheus::Gauge &size_gauge;
+
+  static int64_t now();
+  static std::string entry_key(const std::string &collection, const std::string &key);
+  bool keep(const Negative &negative);
+
+public:
+  NegativeCache();
+
+  // dead returns true if the entity is known dead and not expired yet
+  bool dead(const std::string &collection, const std::string &key);
+  void put(const Negative &negative);
+  // load keeps a negative read back from the collection, it is not counted as found again
+  void load(const Negative &negative);
+
+  // entity maps an api path to the entity it belongs to, /users/{login}/... to users and the login,
+  // /orgs/{org}/... to orgs, /repos/{owner}/{repo}/... to repos and owner/repo, the others to the path.
+  // It returns true if a 404 on the path means the entity is gone: the path is the entity itself or one
+  // of its lists, paged only. /repos/{owner}/{repo}/commits?sha={sha} or /repos/{owner}/{repo}/issues/1
+  // are missing on their own.
+  static bool entity(const std::string &path, std::string &collection, std::string &key);
+};
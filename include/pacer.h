@@ -0,0 +1,33 @@
+#include <chrono>
+#include <mutex>
+#include <random>
+
+#include <metrics.h>
+
+#pragma once
+
+// Pacer spaces the requests of all of the crawler threads evenly, so the budget left of the tokens lasts
+// until their reset instead of being burnt at the start of the window. The interval is stretched
+// multiplicatively on errors and latency spikes and shrinks back additively while the requests go well,
+// max_interval bounds the interval of the budget with its jitter, the stretch goes on top of it.
+class Pacer {
+private:
+  int64_t max_interval; // milliseconds
+
+  std::mutex locker;
+  std::chrono::steady_clock::time_point next; // slot of the next request
+  double factor = 1;                          // stretch of the interval, 1 runs at the budget rate
+  double latency = 0;                         // moving average in milliseconds
+
+  prometheus::Gauge &interval_gauge;
+  prometheus::Gauge &factor_gauge;
+
+public:
+  explicit Pacer(int64_t max_interval, const prometheus::Labels &labels = {});
+
+  // reserve takes the next slot and returns the milliseconds to wait for it, rate is the requests
+  // per second the budget left allows
+  int64_t reserve(double rate);
+  // observe reports the outcome of a request, failed is set for 5xx, transport errors and the secondary rate limit
+  void observe(bool failed, int64_t latency_ms);
+};
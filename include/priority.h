@@ -0,0 +1,52 @@
+#include <cmath>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <common.h>
+#include <const.h>
+#include <frontier.h>
+#include <model.h>
+
+#pragma once
+
+// Priority scores the entities with the data the crawler stores anyway, a user by the followers and the
+// public repos, a repo by the stars and the forks, both lowered by the hops from the entry user. The
+// score is about the decimal digits of the signal, so the bands are 0 up to PRIORITY_BANDS - 1.
+class Priority {
+public:
+  static double user(const User &user, int64_t depth);
+  static double repo(const Repo &repo, int64_t depth);
+  // inherit scores an entity without signals of its own, an org or a branch, by the page it was found on
+  static double inherit(double score);
+
+  static int band(double score);
+};
+
+// PriorityFrontier keeps a frontier for each band of a crawl type. A pop takes most of the batch from the
+// highest bands, every band with keys gets a share weighted by 2^band, so the low bands are not starved.
+// The log of a frontier without bands, name.frontier, is moved into band 0 on open.
+class PriorityFrontier {
+private:
+  std::string legacy; // the log of version 1, before the bands
+  std::mutex locker;  // a key is checked in all of the bands and pushed at once
+  std::vector<std::unique_ptr<Frontier>> bands;
+
+  prometheus::Counter &promoted_counter;
+
+public:
+  // window is the seconds a popped key is not queued again
+  PriorityFrontier(const std::string &dir, const std::string &name, size_t max, int64_t window = 0);
+
+  int open();
+  // push queues the key in the band of the score. A key waiting in a lower band is moved up to it, a key
+  // waiting in a band as high or popped lately is skipped.
+  bool push(const std::string &key, double score, int64_t depth);
+  std::vector<FrontierEntry> pop(size_t count);
+  // requeue puts the popped entries back into their bands, for a batch that could not be crawled
+  void requeue(const std::vector<FrontierEntry> &entries);
+  int commit();
+
+  size_t size();
+};
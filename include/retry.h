@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+
+#include <spdlog/spdlog.h>
+
+#include <fetcher.h>
+#include <metrics.h>
+
+#pragma once
+
+enum retry_class {
+  retry_none,      // success or a failure retrying does not help, such as 404
+  retry_primary,   // 403/429 with the rate limit budget of the token drained, another token is taken
+  retry_secondary, // 403/429 of the secondary rate limit, GitHub asks to slow down
+  retry_server,    // 5xx
+  retry_transport, // no response, such as a timeout or a reset connection
+};
+
+// RetryPolicy decides if and when a failed request is sent again. The delay grows exponentially with
+// full jitter for each error class and Retry-After wins over it. Retries are drawn from a budget filled
+// by the requests, so they can not multiply the load during an outage. Every endpoint has a circuit
+// breaker, it opens after consecutive 5xx or transport failures and lets one probe through after the
+// cooldown.
+class RetryPolicy {
+private:
+  typedef struct Backoff {
+    int64_t base; // milliseconds
+    int64_t cap;  // milliseconds
+  } Backoff;
+
+  typedef struct Breaker {
+    int64_t failures = 0;   // consecutive failures
+    int64_t open_until = 0; // unix milliseconds, 0 if closed
+    bool probing = false;   // a request is testing the half open breaker
+  } Breaker;
+
+  int64_t max_attempts;
+  double budget_ratio;
+  int64_t breaker_failures;
+  int64_t breaker_cooldown; // milliseconds
+  std::map<enum retry_class, Backoff> backoffs;
+
+  std::mutex locker;
+  std::map<std::string, Breaker> breakers;
+  double budget;
+
+  prometheus::Gauge &budget_gauge;
+
+  static int64_t now();
+  static const char *name(enum retry_class retry);
+
+public:
+  // base_delay and max_delay bound the backoff of 5xx in milliseconds, transport errors wait half of it
+  RetryPolicy(int64_t max_attempts, double budget_ratio, int64_t breaker_failures, int64_t breaker_cooldown, int64_t base_delay = 1000,
+              int64_t max_delay = 60000);
+
+  // allow returns false while the breaker of the endpoint is open
+  bool allow(const std::string &endpoint);
+  // record reports the outcome of a request to the breaker of the endpoint and fills the retry budget
+  void record(const std::string &endpoint, enum retry_class retry);
+  // backoff returns the milliseconds to wait before the attempt, -1 if the request must not be retried
+  int64_t backoff(enum retry_class retry, int64_t attempt, const Headers &headers);
+
+  static enum retry_class classify(int status, const Headers &headers, const std::string &body);
+  // endpoint normalizes the path, /users/octocat/followers?page=2 becomes /users/:id/followers
+  static std::string endpoint(const std::string &path);
+};
@@ -0,0 +1,37 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#pragma once
+
+const double REVISIT_TARGET = 0.5;   // chance the entity changed by the time it is visited again
+const int64_t REVISIT_HISTORY = 32; // intervals the estimate remembers, the older ones fade out
+
+// Revisit is the change history of a user or a repo. The changes are taken as a Poisson process, a visit
+// only tells whether updated_at or pushed_at moved since the previous one, not how many times
+typedef struct Revisit {
+  std::string last_change; // updated_at or pushed_at seen on the latest visit
+  int64_t visited_at = 0;  // unix seconds of the latest visit, 0 if never visited
+  double visits = 0;       // intervals between the visits observed
+  double changes = 0;      // intervals the entity changed in
+  double observed = 0;     // seconds of the intervals observed
+  double rate = 0;         // changes per second
+  int64_t next_at = 0;     // unix seconds the entity is due again
+} Revisit;
+
+// revisit_time reads an iso 8601 time of the api, 0 if it is not one
+int64_t revisit_time(const std::string &time);
+
+// revisit_rate estimates the changes per second of the history. The estimator of Cho and Garcia-Molina
+// counts the intervals with a change only, the time since the last change bounds an entity that has not
+// changed between the visits yet
+double revisit_rate(const Revisit &revisit, int64_t now);
+
+// revisit_interval is the wait until the entity changed with REVISIT_TARGET chance, within min and max
+int64_t revisit_interval(double rate, int64_t min, int64_t max);
+
+// revisit_observe folds the visit at now which saw changed_at into the history and schedules the next one
+void revisit_observe(Revisit &revisit, const std::string &changed_at, int64_t now, int64_t min, int64_t max);
@@ -0,0 +1,41 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include <fmt/core.h>
+
+#pragma once
+
+const std::string SEARCH_USERS = "users";
+const std::string SEARCH_REPOS = "repositories";
+
+const int64_t SEARCH_MAX_RESULTS = 1000;           // results of a query the search api returns at most
+const std::string SEARCH_FIRST_DAY = "2007-10-20"; // nothing on GitHub was created before
+const int64_t SEARCH_PASS_PAUSE = 60;              // seconds between two passes over all of the ranges
+const size_t SEARCH_MAX_IN_FLIGHT = 2;             // ranges fetched at the same time, the others wait for the search budget
+
+// SearchRange is a slice of the users or the repos by their creation day, the slices of a single day are
+// cut further by the followers of a user or the stars of a repo
+typedef struct SearchRange {
+  std::string kind;  // SEARCH_USERS or SEARCH_REPOS
+  int64_t from;      // first day of created, days since the epoch
+  int64_t to;        // last day of created
+  int64_t low = 0;   // followers or stars at least
+  int64_t high = -1; // followers or stars at most, -1 is unbounded
+} SearchRange;
+
+// search_all is the range of everything created up to today, today in days since the epoch
+SearchRange search_all(const std::string &kind, int64_t today);
+
+// search_query is the q parameter of the range, `type:user created:2015-01-01..2015-01-31 followers:0..*`
+// with + for the spaces
+std::string search_query(const SearchRange &range);
+
+// split_search halves the days of the range, a range of one day is halved by the followers or stars,
+// returns false if the range is a single day and count already
+bool split_search(const SearchRange &range, SearchRange &first, SearchRange &second);
+
+// search_day formats days since the epoch as 2015-01-31 and parses it back
+std::string search_day(int64_t days);
+int64_t search_day(const std::string &day);
@@ -0,0 +1,54 @@
+#include <functional>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#pragma once
+
+// SingleFlight runs a call once for all of the callers asking the same key at the same time, the callers
+// coming while it is in flight wait for it and get its result. A key is free again once the call returns.
+template <class T>
+class SingleFlight {
+private:
+  std::mutex locker;
+  std::map<std::string, std::shared_future<T>> calls;
+
+public:
+  // shared is set if the result comes from the call of another caller
+  T run(const std::string &key, const std::function<T()> &call, bool &shared) {
+    std::shared_ptr<std::promise<T>> promise;
+    std::shared_future<T> future;
+    {
+      std::lock_guard<std::mutex> lock(locker);
+      auto it = calls.find(key);
+      shared = it != calls.end();
+      if (shared) {
+        future = it->second;
+      } else {
+        promise = std::make_shared<std::promise<T>>();
+        calls.emplace(key, promise->get_future().share());
+      }
+    }
+    if (shared) {
+      return future.get();
+    }
+
+    T result;
+    try {
+      result = call();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(locker);
+      calls.erase(key);
+      promise->set_exception(std::current_exception());
+      throw;
+    }
+    {
+      std::lock_guard<std::mutex> lock(locker);
+      calls.erase(key);
+    }
+    promise->set_value(result);
+    return result;
+  }
+};
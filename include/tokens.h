@@ -0,0 +1,93 @@
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <fetcher.h>
+#include <metrics.h>
+
+#pragma once
+
+const std::string RESOURCE_CORE = "core";
+const std::string RESOURCE_GRAPHQL = "graphql";
+const std::string RESOURCE_SEARCH = "search";
+
+typedef struct TokenBudget {
+  int64_t limit = 5000;
+  int64_t remaining = 5000; // X-RateLimit-Remaining of the latest response
+  int64_t reset = 0;        // X-RateLimit-Reset, unix seconds
+  int64_t in_flight = 0;    // acquired but not answered yet
+  int64_t paused_until = 0; // unix seconds, set by Retry-After
+  bool known = false;       // the budget has been reported by GitHub
+  int64_t granted = 0;      // requests of the shared budget reserved by this replica and not sent yet
+  int64_t window = 0;       // reset of the window the granted requests belong to
+  bool reserving = false;   // a chunk of the shared budget is being reserved
+  bool exhausted = false;   // the replicas have reserved the whole budget of the window
+} TokenBudget;
+
+// BudgetReserver reserves up to chunk requests of the token and resource in the window for this replica
+// from the budget shared by all of the replicas, cap is the whole budget, the requests granted are returned
+typedef std::function<int64_t(int index, const std::string &resource, int64_t window, int64_t cap, int64_t chunk)> BudgetReserver;
+
+// TokenScheduler tracks the rate limit budget of every token and resource (core, search, graphql)
+// separately, and hands out the token which has the most budget left. A token is not used anymore
+// when its budget drops to the reserve, and it becomes available again at its reset time. If the tokens
+// are shared by several replicas, a request also spends one of the requests the replica reserved of the
+// shared budget in chunks, so the replicas together stay below the limit. Until GitHub reports the reset
+// of a token, the replica sends one request of it at a time without reserving the shared budget.
+class TokenScheduler {
+private:
+  std::vector<std::string> tokens;
+  int64_t reserve;
+
+  std::mutex locker;
+  std::condition_variable changed;
+  std::vector<std::map<std::string, TokenBudget>> budgets; // token index -> resource -> budget
+  bool stopping = false;
+
+  BudgetReserver reserver;
+  int64_t chunk = 0;
+
+  static int64_t now();
+  int64_t kept(const TokenBudget &budget);
+  int64_t window(TokenBudget &budget);
+  bool reserve_chunk(std::unique_lock<std::mutex> &lock, int index, const std::string &resource);
+  int64_t available(TokenBudget &budget, int64_t current);
+  void observe(int index, const std::string &resource, const TokenBudget &budget);
+  double rate(TokenBudget &budget, int64_t current);
+
+public:
+  TokenScheduler(std::vector<std::string> tokens, int64_t reserve);
+
+  // share spends the budget reserved with the reserver in chunks, before the budget of the token is used
+  void share(BudgetReserver budget_reserver, int64_t budget_chunk);
+
+  // acquire blocks until a token has budget for the resource, returns -1 if the scheduler is stopping
+  int acquire(const std::string &resource = RESOURCE_CORE);
+  // release gives back a token when the request got no response
+  void release(int index, const std::string &resource = RESOURCE_CORE);
+  // update releases the token with the X-RateLimit-* headers of the response, returns true
+  // if the request was rejected by the rate limit and should be retried with another token
+  bool update(int index, int status, const Headers &headers, const std::string &resource = RESOURCE_CORE);
+  // drain takes the token out for the resource until its reset, for seconds if the reset is unknown or passed
+  void drain(int index, const std::string &resource, int64_t seconds);
+  // set the budget reported by /rate_limit
+  void set(int index, const std::string &resource, int64_t limit, int64_t remaining, int64_t reset);
+  void stop();
+
+  const std::string &token(int index) { return tokens[index]; }
+  size_t size() { return tokens.size(); }
+  // id names the token without revealing it, the same token has the same id on all of the replicas
+  std::string id(int index);
+  // the budget left of all of the tokens for the resource
+  int64_t total(const std::string &resource = RESOURCE_CORE);
+  // rate returns the requests per second the budget left of all of the tokens allows until their resets
+  double rate(const std::string &resource = RESOURCE_CORE);
+  // rate of one token only, the pace of its lane
+  double rate(int index, const std::string &resource = RESOURCE_CORE);
+};
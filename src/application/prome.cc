@@ -15,6 +15,8 @@ Prome::~Prome() {
     }
   }
 
+  delete exposer;
+
   spdlog::info("Prometheus expoter stopped...");
 }
 
@@ -22,14 +24,7 @@ int Prome::startup() {
   semaphore++;
   std::thread prome_thread([=, this]() {
     exposer = new prometheus::Exposer("0.0.0.0:8080");
-    auto registry = std::make_shared<prometheus::Registry>();
-    auto &packet_counter = prometheus::BuildCounter()
-                               .Name("observed_packets_total")
-                               .Help("Number of observed packets")
-                               .Register(*registry);
-    auto &tcp_rx_counter = packet_counter.Add({{"protocol", "tcp"}, {"direction", "rx"}});
-    tcp_rx_counter.Increment();
-    exposer->RegisterCollectable(registry);
+    exposer->RegisterCollectable(Metrics::registry());
     semaphore--;
   });
   prome_thread.detach();
@@ -2,40 +2,23 @@
 
 int Request::startup_repos_branches() {
   if (this->config.crawler_type_users_repos_branches) {
-    this->semaphore++;
-    std::thread users_repos_branches_thread([=, this]() {
-      spdlog::info("Users repos branches thread is starting...");
-      while (!stopping) {
-        std::vector<std::string> repos = database->list_repos_random(request_type_users_repos);
-        for (const std::string &repo : repos) {
-          std::vector<std::string> repo_list;
-          boost::algorithm::split(repo_list, repo, boost::algorithm::is_any_of(KEYS_DELIMITER));
-          if (repo_list.size() != 2) {
-            spdlog::error("Invalid repo: {}", repo);
-            continue;
-          }
-          ExtraData extra;
-          extra.repo = repo_list[0];
-          extra.user = repo_list[1];
-          RequestConfig request_config{
-              .host = this->default_url_prefix,
-              .path = "/repos/" + repo_list[1] + "/" + repo_list[0] + "/branches?per_page=100",
-          };
-          request_config.extra = extra;
-          int code = request(request_config, request_type_users_repos_branches, request_type_users_repos_branches);
-          if (code != 0) {
-            spdlog::error("Request url: {} with error: {}", request_config.path, code);
-          }
-          if (stopping) {
-            break;
-          }
-        }
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+    this->crawl("users_repos_branches", [this]() { return database->list_repos_random(request_type_users_repos); }, [this](const std::string &repo, RequestConfig &request_config) {
+      std::vector<std::string> repo_list;
+      boost::algorithm::split(repo_list, repo, boost::algorithm::is_any_of(KEYS_DELIMITER));
+      if (repo_list.size() != 2) {
+        spdlog::error("Invalid repo: {}", repo);
+        return false;
       }
-      spdlog::info("Users repos branches thread stopped");
-      semaphore--;
-    });
-    users_repos_branches_thread.detach();
+      ExtraData extra;
+      extra.repo = repo_list[0];
+      extra.user = repo_list[1];
+      request_config = RequestConfig{
+          .host = this->default_url_prefix,
+          .path = "/repos/" + repo_list[1] + "/" + repo_list[0] + "/branches?per_page=100",
+      };
+      request_config.extra = extra;
+      return true;
+    }, request_type_users_repos_branches);
   }
   return EXIT_SUCCESS;
 }
@@ -52,5 +35,8 @@ int Request::request_repo_branches(nlohmann::json content, ExtraData extra, enum
     branches.push_back(branch);
   }
   WRAP_FUNC(database->upsert_branch(branches))
+  for (const Branch &branch : branches) {
+    this->discover("users_repos_branches_commits", branch.repo + KEYS_DELIMITER + branch.owner + KEYS_DELIMITER + branch.name, Priority::inherit(extra.score), extra.depth + 1);
+  }
   return EXIT_SUCCESS;
 }
@@ -2,41 +2,24 @@
 
 int Request::startup_repos_branches_commits() {
   if (this->config.crawler_type_users_repos_branches_commits) {
-    this->semaphore++;
-    std::thread users_repos_branches_commits_thread([=, this]() {
-      spdlog::info("Users repos branches commits thread is starting...");
-      while (!stopping) {
-        std::vector<std::string> branches = database->list_branches_random(request_type_users_repos);
-        for (const std::string &branch : branches) {
-          std::vector<std::string> branch_list;
-          boost::algorithm::split(branch_list, branch, boost::algorithm::is_any_of(KEYS_DELIMITER));
-          if (branch_list.size() != 3) {
-            spdlog::error("Invalid branch: {}", branch);
-            continue;
-          }
-          ExtraData extra;
-          extra.repo = branch_list[0];
-          extra.user = branch_list[1];
-          extra.branch = branch_list[2];
-          RequestConfig request_config{
-              .host = this->default_url_prefix,
-              .path = fmt::format("/repos/{}/{}/commits?sha={}&per_page=100", branch_list[1], branch_list[0], branch_list[2]),
-          };
-          request_config.extra = extra;
-          int code = request(request_config, request_type_users_repos_branches_commits, request_type_users_repos_branches_commits);
-          if (code != 0) {
-            spdlog::error("Request url: {} with error: {}", request_config.path, code);
-          }
-          if (stopping) {
-            break;
-          }
-        }
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+    this->crawl("users_repos_branches_commits", [this]() { return database->list_branches_random(request_type_users_repos); }, [this](const std::string &branch, RequestConfig &request_config) {
+      std::vector<std::string> branch_list;
+      boost::algorithm::split(branch_list, branch, boost::algorithm::is_any_of(KEYS_DELIMITER));
+      if (branch_list.size() != 3) {
+        spdlog::error("Invalid branch: {}", branch);
+        return false;
       }
-      spdlog::info("Users repos branches commits thread stopped");
-      semaphore--;
-    });
-    users_repos_branches_commits_thread.detach();
+      ExtraData extra;
+      extra.repo = branch_list[0];
+      extra.user = branch_list[1];
+      extra.branch = branch_list[2];
+      request_config = RequestConfig{
+          .host = this->default_url_prefix,
+          .path = fmt::format("/repos/{}/{}/commits?sha={}&per_page=100", branch_list[1], branch_list[0], branch_list[2]),
+      };
+      request_config.extra = extra;
+      return true;
+    }, request_type_users_repos_branches_commits);
   }
   return EXIT_SUCCESS;
 }
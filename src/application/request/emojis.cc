@@ -2,9 +2,8 @@
 
 int Request::startup_emojis() {
   if (this->config.crawler_type_emojis) {
-    this->semaphore++;
-    std::thread emojis_thread([=, this]() {
-      spdlog::info("Emoji thread is starting...");
+    executor->submit("emojis", [this]() {
+      spdlog::info("Emoji crawl is starting...");
       RequestConfig request_config{
           .host = this->default_url_prefix,
           .path = "/emojis",
@@ -13,10 +12,8 @@ int Request::startup_emojis() {
       if (code != 0) {
         spdlog::error("Request url: {} with error: {}", request_config.path, code);
       }
-      spdlog::info("Emoji thread stopped");
-      semaphore--;
+      spdlog::info("Emoji crawl is done");
     });
-    emojis_thread.detach();
   }
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,20 @@
+#include <application/request.h>
+
+void Request::save_etag(const std::string &url, const FetchResponse &response, const std::string &link, std::vector<std::string> keys) {
+  Etag etag{.url = url, .link = link, .keys = std::move(keys)};
+  auto it = response.headers.find("ETag");
+  if (it != response.headers.end()) {
+    etag.etag = it->second;
+  }
+  it = response.headers.find("Last-Modified");
+  if (it != response.headers.end()) {
+    etag.last_modified = it->second;
+  }
+  if (etag.etag.empty() && etag.last_modified.empty()) {
+    return;
+  }
+  int code = database->upsert_etag(etag);
+  if (code != 0) {
+    spdlog::error("Database with error: {}", code);
+  }
+}
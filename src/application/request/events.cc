@@ -0,0 +1,57 @@
+#include <application/request.h>
+
+// startup_events polls the first page of the public events as often as the server allows, a page that
+// did not change since the last poll is answered with 304 and costs no rate limit
+int Request::startup_events() {
+  if (!config.crawler_type_events) {
+    return EXIT_SUCCESS;
+  }
+  events_thread = std::thread([this]() {
+    spdlog::info("Events poller is starting...");
+    while (!this->stopping) {
+      RequestConfig request_config{
+          .host = this->default_url_prefix,
+          .path = EVENTS_PATH,
+      };
+      request_config.extra.depth = PRIORITY_SAMPLED_DEPTH; // the hops from the entry user are unknown
+      request_config.extra.score = PRIORITY_BANDS - 1;     // an entity active right now goes first
+      PageCursor cursor;
+      int code = this->request_page(request_config, request_type_events, request_type_events, true, cursor);
+      if (code != 0) {
+        spdlog::error("Request url: {} with error: {}", request_config.path, code);
+      }
+      this->pause((cursor.poll > 0 ? cursor.poll : EVENTS_POLL_INTERVAL) * 1000);
+    }
+  });
+  return EXIT_SUCCESS;
+}
+
+// request_events updates the pushed_at, the stars and the forks of the known repos in place, the actors
+// are handled like the users of a list page, the branches, the commits and the repos of the owners the
+// events touched are queued in the top band of their crawl types. The newest event handled is stored, the
+// events a replica or the run before the restart handled are not applied again, a $inc of them would be.
+int Request::request_events(const nlohmann::json &content, const ExtraData &extra, enum request_type type_from) {
+  EventActions actions = event_actions(content, last_event);
+  if (actions.count == 0) {
+    return EXIT_SUCCESS;
+  }
+  int64_t stored = database->advance_events(actions.last);
+  if (stored < 0) {
+    return SQL_EXEC_ERROR;
+  }
+  int64_t newest = std::max(actions.last, stored);
+  if (stored > last_event) {
+    actions = event_actions(content, stored);
+  }
+  last_event = newest;
+  if (actions.count == 0) {
+    return EXIT_SUCCESS;
+  }
+  events_counter.Increment(static_cast<double>(actions.count));
+  WRAP_FUNC(database->touch_repos(actions.repos))
+  WRAP_FUNC(this->request_users(actions.users, extra, type_from))
+  for (const auto &[queue, key] : actions.recrawls) {
+    this->discover(queue, key, extra.score, extra.depth);
+  }
+  return EXIT_SUCCESS;
+}
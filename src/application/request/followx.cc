@@ -2,100 +2,72 @@
 
 int Request::startup_followx() {
   if (config.crawler_type_followers) {
-    semaphore++;
-    std::thread followers_thread([=, this]() {
-      spdlog::info("Followers thread is starting...");
-      while (!stopping) {
-        std::vector<std::string> users = database->list_users_random(request_type_followers);
-        for (const std::string &u : users) {
-          RequestConfig request_config{
-              .host = this->default_url_prefix,
-              .path = "/users/" + u + "/followers?per_page=100",
-          };
-          int code = request(request_config, request_type_followers, request_type_followers);
-          if (code != 0) {
-            spdlog::error("Request url: {} with error: {}", request_config.path, code);
-          }
-          if (stopping) {
-            break;
-          }
-        }
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-      }
-      spdlog::info("Followers thread stopped");
-      semaphore--;
-    });
-    followers_thread.detach();
+    this->crawl("followers", [this]() { return database->list_users_random(request_type_followers); }, [this](const std::string &u, RequestConfig &request_config) {
+      request_config = RequestConfig{
+          .host = this->default_url_prefix,
+          .path = "/users/" + u + "/followers?per_page=100",
+      };
+      return true;
+    }, request_type_followers);
   }
   if (config.crawler_type_followings) {
-    semaphore++;
-    std::thread followings_thread([=, this]() {
-      spdlog::info("Following thread is starting...");
-      while (!stopping) {
-        std::vector<std::string> users = database->list_users_random(request_type_following);
-        for (const std::string &u : users) {
-          RequestConfig request_config{
-              .host = this->default_url_prefix,
-              .path = "/users/" + u + "/following?per_page=100",
-          };
-          int code = request(request_config, request_type_following, request_type_following);
-          if (code != 0) {
-            spdlog::error("Request url: {} with error: {}", request_config.path, code);
-          }
-          if (stopping) {
-            break;
-          }
-        }
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-      }
-      spdlog::info("Following thread stopped");
-      semaphore--;
-    });
-    followings_thread.detach();
+    this->crawl("following", [this]() { return database->list_users_random(request_type_following); }, [this](const std::string &u, RequestConfig &request_config) {
+      request_config = RequestConfig{
+          .host = this->default_url_prefix,
+          .path = "/users/" + u + "/following?per_page=100",
+      };
+      return true;
+    }, request_type_following);
   }
   return EXIT_SUCCESS;
 }
 
-int Request::request_user(nlohmann::json content, enum request_type type_from) {
-  User user;
-  if (content["hireable"].dump() != "true") {
-    content["hireable"] = false;
+int Request::request_user(const User &user, const ExtraData &extra, enum request_type type_from) {
+  this->revisit("users", {{user.login, user.updated_at}});
+  if (type_from == request_type_user) { // a profile of the enrichment queue, the graph is expanded again by its signals
+    WRAP_FUNC(database->upsert_user(user))
+    this->discover_user(user, Priority::user(user, extra.depth), extra.depth);
+    return EXIT_SUCCESS;
   }
-  user.login = content["login"].get<std::string>();
-  user.id = content["id"].get<int64_t>();
-  user.node_id = content["node_id"].get<std::string>();
-  user.type = content["type"].get<std::string>();
-  user.name = content["name"].get<std::string>();
-  user.company = content["company"].get<std::string>();
-  user.blog = content["blog"].get<std::string>();
-  user.location = content["location"].get<std::string>();
-  user.email = content["email"].get<std::string>();
-  user.hireable = content["hireable"].get<bool>();
-  user.bio = content["bio"].get<std::string>();
-  user.created_at = content["created_at"].get<std::string>();
-  user.updated_at = content["updated_at"].get<std::string>();
-  user.public_gists = content["public_gists"].get<int64_t>();
-  user.public_repos = content["public_repos"].get<int64_t>();
-  user.following = content["following"].get<int64_t>();
-  user.followers = content["followers"].get<int64_t>();
+  WRAP_FUNC(database->upsert_user_with_version(user, type_from))
+  this->discover_user(user, Priority::user(user, extra.depth), extra.depth);
+  return EXIT_SUCCESS;
+}
 
-  int code = database->upsert_user_with_version(user, type_from);
-  return code;
+int Request::request_followx(const std::vector<User> &users, const ExtraData &extra, enum request_type type_from) {
+  return this->request_users(users, extra, type_from);
 }
 
-int Request::request_followx(const nlohmann::json &content, enum request_type type_from) {
-  for (auto i : content) {
-    RequestConfig request_config{
-        .host = this->default_url_prefix,
-        .path = "/users/" + i["login"].get<std::string>(),
-    };
-    int code = request(request_config, request_type_user, type_from);
-    if (code != 0) {
-      spdlog::error("Request userinfo with error: {}", code);
-      return code;
-    }
-    if (stopping) {
-      return EXIT_SUCCESS;
+// request_users keeps what a follower, member or search page tells of its users and expands the graph from them
+// at once, the profiles are queued for the enrichment unless they are fresh
+int Request::request_users(const std::vector<User> &users, const ExtraData &extra, enum request_type type_from) {
+  if (users.empty()) {
+    return EXIT_SUCCESS;
+  }
+  std::vector<std::string> ids;
+  std::vector<std::string> logins;
+  for (const User &user : users) {
+    ids.push_back(std::to_string(user.id));
+    logins.push_back(user.login);
+  }
+  WRAP_FUNC(database->upsert_user_stub(users))
+  if (type_from != request_type_search_users && type_from != request_type_events) { // a search or an event has no crawl version
+    WRAP_FUNC(database->update_version(ids, type_from))
+  }
+
+  std::map<std::string, User> fresh;
+  for (User &user : database->list_users_fresh(logins, config.crawler_profile_ttl)) {
+    fresh[user.login] = std::move(user);
+  }
+  // a user is scored by the signals of its stored profile or of the page, a stub without any takes the score
+  // of the page one hop further, and is scored again once its profile is fetched
+  for (const User &user : users) {
+    auto it = fresh.find(user.login);
+    const User &signals = it != fresh.end() ? it->second : user;
+    double score = signals.followers > 0 || signals.public_repos > 0 ? Priority::user(signals, extra.depth + 1) : Priority::inherit(extra.score);
+    this->discover_user(user, score, extra.depth + 1);
+    if (it == fresh.end()) {
+      this->discover(PROFILES_QUEUE, user.login, score, extra.depth + 1);
     }
   }
   return EXIT_SUCCESS;
@@ -0,0 +1,57 @@
+#include <application/request.h>
+
+int Request::startup_frontier() {
+  std::vector<std::pair<std::string, bool>> queues{
+      {"followers", config.crawler_type_followers},
+      {"following", config.crawler_type_followings},
+      {"orgs", config.crawler_type_orgs},
+      {"orgs_member", config.crawler_type_orgs_member},
+      {"users_repos", config.crawler_type_users_repos},
+      {"orgs_repos", config.crawler_type_orgs_repos},
+      {"users_repos_branches", config.crawler_type_users_repos_branches},
+      {"users_repos_branches_commits", config.crawler_type_users_repos_branches_commits},
+      {PROFILES_QUEUE, config.crawler_type_followers || config.crawler_type_followings || config.crawler_type_orgs_member},
+  };
+  for (const auto &[queue, enabled] : queues) {
+    if (!enabled) {
+      continue;
+    }
+    // a key crawled lately is not queued again before it may be revisited
+    auto *frontier = new PriorityFrontier(config.crawler_frontier_dir, queue, static_cast<size_t>(config.crawler_frontier_max), config.crawler_revisit_min);
+    frontiers[queue] = frontier;
+    WRAP_FUNC(frontier->open())
+  }
+  return EXIT_SUCCESS;
+}
+
+// discover queues the key of a new entity for the crawl type, a disabled type has no frontier
+void Request::discover(const std::string &queue, const std::string &key, double score, int64_t depth) {
+  auto it = frontiers.find(queue);
+  if (it != frontiers.end()) {
+    it->second->push(key, score, depth);
+  }
+}
+
+void Request::discover_user(const User &user, double score, int64_t depth) {
+  this->discover("followers", user.login, score, depth);
+  this->discover("following", user.login, score, depth);
+  this->discover("orgs", user.login, score, depth);
+  this->discover("users_repos", user.login, score, depth);
+}
+
+void Request::discover_org(const Org &org, double score, int64_t depth) {
+  this->discover("orgs_member", org.login, score, depth);
+  this->discover("orgs_repos", org.login, score, depth);
+}
+
+// revisit schedules the next visit of the entities by their change history, changes maps the key of an
+// entity to its updated_at or pushed_at, empty if the visit only learned it did not change
+void Request::revisit(const std::string &collection, const std::map<std::string, std::string> &changes) {
+  if (config.crawler_revisit_max <= 0) {
+    return;
+  }
+  int code = database->observe_revisits(collection, changes, config.crawler_revisit_min, config.crawler_revisit_max);
+  if (code != 0) {
+    spdlog::error("Database with error: {}", code);
+  }
+}
@@ -2,9 +2,8 @@
 
 int Request::startup_gitignore() {
   if (config.crawler_type_gitignore_list) {
-    semaphore++;
-    std::thread gitignore_list_thread([=, this]() {
-      spdlog::info("Gitignore list thread is starting...");
+    executor->submit("gitignore", [this]() {
+      spdlog::info("Gitignore list crawl is starting...");
       RequestConfig request_config{
           .host = this->default_url_prefix,
           .path = "/gitignore/templates",
@@ -13,10 +12,8 @@ int Request::startup_gitignore() {
       if (code != 0) {
         spdlog::error("Request url: {} with error: {}", request_config.path, code);
       }
-      spdlog::info("Gitignore list thread stopped");
-      semaphore--;
+      spdlog::info("Gitignore list crawl is done");
     });
-    gitignore_list_thread.detach();
   }
   return EXIT_SUCCESS;
 }
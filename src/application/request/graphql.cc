@@ -0,0 +1,84 @@
+#include <application/request.h>
+
+// graphql_users fetches the profiles of up to GRAPHQL_MAX_NODES logins with one aliased query,
+// missing gets the logins GraphQL does not resolve to a User, such as bots. A token out of points is
+// taken out until its reset and the query is sent again with another one. The query goes through the
+// breaker, the lane and the pacer of its token the same as a page of fetch_page.
+int Request::graphql_users(const std::vector<std::string> &logins, std::vector<User> &users, std::vector<std::string> &missing) {
+  RequestConfig request_config{
+      .host = this->default_url_prefix,
+      .path = "/graphql",
+  };
+  std::string body = nlohmann::json{{"query", graphql_users_query(logins)}}.dump();
+  std::string endpoint = RetryPolicy::endpoint(request_config.path);
+  while (true) {
+    if (!retry->allow(endpoint)) {
+      spdlog::error("Circuit of {} is open, skip {}", endpoint, request_config.path);
+      return CIRCUIT_OPEN;
+    }
+    if (!fair->acquire(PROFILES_QUEUE)) {
+      return EXIT_SUCCESS;
+    }
+    if (!lanes->split()) { // a lane paces its token after the token is picked
+      this->pause(lanes->reserve(-1));
+    }
+    int token = tokens->acquire(RESOURCE_GRAPHQL);
+    if (token < 0) {
+      fair->release();
+      return EXIT_SUCCESS;
+    }
+    Lane lane = lanes->lane(token); // the query goes over the connections and the pace of its token, as a page does
+    if (lanes->split()) {
+      this->pause(lanes->reserve(token));
+    }
+    FetchRequest fetch_request = this->prepare(request_config, token);
+    fetch_request.method = "POST";
+    fetch_request.body = body;
+    fetch_request.headers.insert(std::make_pair("Content-Type", "application/json"));
+
+    auto start = std::chrono::steady_clock::now();
+    FetchResponse response = lane.fetcher->submit(fetch_request).get();
+    int64_t latency = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    fair->release();
+    bool limited = false;
+    if (response.status == 0) {
+      tokens->release(token, RESOURCE_GRAPHQL);
+    } else {
+      limited = tokens->update(token, response.status, response.headers, RESOURCE_GRAPHQL);
+    }
+    if (this->stopping) {
+      return EXIT_SUCCESS;
+    }
+
+    enum retry_class retry_class = RetryPolicy::classify(response.status, response.headers, response.body);
+    retry->record(endpoint, retry_class);
+    lane.pacer->observe(retry_class == retry_secondary || retry_class == retry_server || retry_class == retry_transport, latency);
+    if (limited || retry_class == retry_primary) {
+      SPDLOG_INFO("Token {} is rate limited on {}, retry with another token", token, request_config.path);
+      continue;
+    }
+    if (response.status == 0) { // the caller backs off and sends the query again
+      spdlog::error("Request with error: {}, {}", request_config.path, response.error);
+      return REQUEST_ERROR;
+    }
+    if (response.status != 200) {
+      spdlog::error("Got {} on request url: {}{}, {}", response.status, request_config.host, request_config.path, response.body);
+      return REQUEST_ERROR;
+    }
+
+    std::vector<User> parsed;
+    std::vector<std::string> unresolved;
+    int code = graphql_users_parse(response.body, logins, parsed, unresolved);
+    if (code == RATE_LIMITED_ERROR) { // a 200 without data, the points are spent although the headers may not say so
+      SPDLOG_INFO("Token {} is out of graphql points, retry with another token", token);
+      tokens->drain(token, RESOURCE_GRAPHQL, GRAPHQL_RATE_LIMIT_PAUSE);
+      continue;
+    }
+    if (code != 0) {
+      return code;
+    }
+    users.insert(users.end(), parsed.begin(), parsed.end());
+    missing.insert(missing.end(), unresolved.begin(), unresolved.end());
+    return EXIT_SUCCESS;
+  }
+}
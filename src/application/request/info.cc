@@ -1,8 +1,7 @@
 #include <application/request.h>
 
 int Request::startup_info() {
-  semaphore++;
-  std::thread info_thread([=, this]() {
+  info_thread = std::thread([this]() {
     spdlog::info("Info thread is starting...");
     int checker = 0;
     while (!stopping) {
@@ -12,6 +11,8 @@ int Request::startup_info() {
         int64_t user_count = database->count_user();
         int64_t org_count = database->count_org();
         spdlog::info("Database have users: {}, orgs: {}", user_count, org_count);
+        spdlog::info("Connections created: {}, reused: {}", fetcher->created(), fetcher->reused());
+        spdlog::info("Body bytes on the wire: {}, decoded: {}", fetcher->wire_bytes(), fetcher->decoded_bytes());
 
         fort::char_table table;
         table.set_border_style(FT_DOUBLE2_STYLE);
@@ -21,7 +22,15 @@ int Request::startup_info() {
               << "users"
               << user_count << fort::endr
               << "orgs"
-              << org_count << fort::endr;
+              << org_count << fort::endr
+              << "connections created"
+              << fetcher->created() << fort::endr
+              << "connections reused"
+              << fetcher->reused() << fort::endr
+              << "body bytes on the wire"
+              << fetcher->wire_bytes() << fort::endr
+              << "body bytes decoded"
+              << fetcher->decoded_bytes() << fort::endr;
 
         table.column(1).set_cell_text_align(fort::text_align::center);
 
@@ -31,8 +40,6 @@ int Request::startup_info() {
       std::this_thread::sleep_for(std::chrono::seconds(1));
     }
     spdlog::info("Info thread stopped");
-    this->semaphore--;
   });
-  info_thread.detach();
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,68 @@
+#include <unistd.h>
+
+#include <cstring>
+#include <set>
+
+#include <application/request.h>
+
+// startup_lease names this replica and renews its leases every third of the ttl, a replica that dies
+// stops renewing and its keys are claimed by the others once the leases expire
+int Request::startup_lease() {
+  if (config.crawler_lease_ttl == 0) {
+    return EXIT_SUCCESS;
+  }
+  char hostname[256]{};
+  if (gethostname(hostname, sizeof(hostname) - 1) != 0) {
+    spdlog::error("Get hostname with error: {}", strerror(errno));
+    return LEASE_ERROR;
+  }
+  lease_owner = fmt::format("{}:{}", hostname, getpid());
+  spdlog::info("Spider leases the crawl as {}", lease_owner);
+
+  lease_thread = std::thread([this]() {
+    while (!this->stopping) {
+      this->pause(config.crawler_lease_ttl * 1000 / 3);
+      if (!this->stopping) {
+        database->renew_leases(lease_owner, config.crawler_lease_ttl);
+      }
+    }
+  });
+  return EXIT_SUCCESS;
+}
+
+// claim keeps the entries of the batch this replica holds the lease of, the others are crawled by the
+// replicas holding them or were crawled lately. If the leases can not be claimed no entry is kept, the
+// caller puts the batch back.
+int Request::claim(const std::string &queue, const std::vector<FrontierEntry> &entries, std::vector<FrontierEntry> &result) {
+  if (lease_owner.empty() || entries.empty()) {
+    result = entries;
+    return EXIT_SUCCESS;
+  }
+  std::vector<std::string> keys;
+  for (const FrontierEntry &entry : entries) {
+    keys.push_back(entry.key);
+  }
+  std::vector<std::string> claimed;
+  WRAP_FUNC(database->claim_leases(queue, keys, lease_owner, config.crawler_lease_ttl, claimed))
+  std::set<std::string> held(claimed.begin(), claimed.end());
+  for (const FrontierEntry &entry : entries) {
+    if (held.contains(entry.key)) {
+      result.push_back(entry);
+    }
+  }
+  prometheus::Labels labels{{"queue", queue}};
+  Metrics::counter("spider_leases_claimed_total", "Keys leased to this replica", labels).Increment(static_cast<double>(result.size()));
+  Metrics::counter("spider_leases_skipped_total", "Keys leased to another replica or crawled lately", labels).Increment(static_cast<double>(entries.size() - result.size()));
+  return EXIT_SUCCESS;
+}
+
+// finish holds the crawled key from the other replicas, a failure leaves the lease to expire after the ttl
+void Request::finish(const std::string &queue, const std::string &key) {
+  if (lease_owner.empty()) {
+    return;
+  }
+  int code = database->finish_lease(queue, key, lease_owner, config.crawler_lease_hold);
+  if (code != 0) {
+    spdlog::error("Finish lease of {} {} with error: {}", queue, key, code);
+  }
+}
@@ -2,9 +2,8 @@
 
 int Request::startup_license() {
   if (config.crawler_type_license_list) {
-    semaphore++;
-    std::thread license_list_thread([=, this]() {
-      spdlog::info("License list thread is starting...");
+    executor->submit("license", [this]() {
+      spdlog::info("License list crawl is starting...");
       RequestConfig request_config{
           .host = this->default_url_prefix,
           .path = "/licenses",
@@ -13,10 +12,8 @@ int Request::startup_license() {
       if (code != 0) {
         spdlog::error("Request url: {} with error: {}", request_config.path, code);
       }
-      spdlog::info("License list thread stopped");
-      semaphore--;
+      spdlog::info("License list crawl is done");
     });
-    license_list_thread.detach();
   }
   return EXIT_SUCCESS;
 }
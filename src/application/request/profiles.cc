@@ -0,0 +1,126 @@
+#include <application/request.h>
+
+int Request::startup_profiles() {
+  if (frontiers.contains(PROFILES_QUEUE)) {
+    this->enrich();
+  }
+  return EXIT_SUCCESS;
+}
+
+// enrich fetches the profiles of a batch of the enrichment queue and submits itself again, the stale
+// profiles of the database are sampled when the queue is drained. The requests are charged to the
+// profiles share, so the enrichment takes the budget the crawl of the graph leaves.
+void Request::enrich() {
+  executor->submit(PROFILES_QUEUE, [this]() {
+    if (this->stopping) {
+      return;
+    }
+    PriorityFrontier *frontier = frontiers.at(PROFILES_QUEUE);
+    std::vector<FrontierEntry> entries = frontier->pop(GRAPHQL_MAX_NODES);
+    bool popped = !entries.empty();
+    if (entries.empty()) {
+      for (const std::string &login : database->list_users_stale(config.crawler_profile_ttl)) {
+        entries.push_back(FrontierEntry{.key = login, .depth = PRIORITY_SAMPLED_DEPTH, .score = PRIORITY_SAMPLED_SCORE});
+      }
+    }
+    std::vector<FrontierEntry> claimed;
+    if (int code = this->claim(PROFILES_QUEUE, entries, claimed); code != 0) {
+      spdlog::error("Claim leases of {} with error: {}", PROFILES_QUEUE, code);
+      if (popped) { // the batch is queued again and not committed, no login of it is lost
+        frontier->requeue(entries);
+      }
+      this->pause(1000);
+      this->enrich();
+      return;
+    }
+    if (claimed.empty()) {
+      frontier->commit();
+      this->pause(1000);
+      this->enrich();
+      return;
+    }
+    int code = this->hydrate(claimed);
+    if (code != 0) {
+      spdlog::error("Request profiles with error: {}", code);
+    }
+    if (!this->stopping) { // a batch cut by the shutdown is popped again after the restart
+      for (const FrontierEntry &entry : claimed) {
+        this->finish(PROFILES_QUEUE, entry.key);
+      }
+      frontier->commit();
+    }
+    this->enrich();
+  });
+}
+
+// hydrate fetches the profiles of the logins, GRAPHQL_MAX_NODES of them in one GraphQL query if hydration
+// is graphql, /users/{login} is the fallback for the logins GraphQL cannot resolve. A failed query backs
+// off and is sent again, a hundred REST requests for it would drain the core budget as well. The users
+// are queued again by the signals of their profiles, the stubs were queued by the page they were found on.
+int Request::hydrate(const std::vector<FrontierEntry> &entries) {
+  std::map<std::string, int64_t> depths;
+  std::vector<std::string> logins;
+  for (const FrontierEntry &entry : entries) {
+    depths[entry.key] = entry.depth;
+    logins.push_back(entry.key);
+  }
+  std::vector<std::string> rest;
+  for (size_t begin = 0; begin < logins.size(); begin += GRAPHQL_MAX_NODES) {
+    std::vector<std::string> batch(logins.begin() + static_cast<int64_t>(begin), logins.begin() + static_cast<int64_t>(std::min(logins.size(), begin + GRAPHQL_MAX_NODES)));
+    if (config.crawler_hydration != HYDRATION_GRAPHQL) {
+      rest.insert(rest.end(), batch.begin(), batch.end());
+      continue;
+    }
+
+    std::vector<User> hydrated;
+    std::vector<std::string> missing;
+    int code = this->graphql_users(batch, hydrated, missing);
+    for (int64_t attempt = 0; code != 0 && !stopping; attempt++) {
+      int64_t delay = retry->backoff(retry_server, attempt, Headers{});
+      if (delay < 0) { // the profiles stay stale and are sampled again
+        break;
+      }
+      spdlog::error("Request graphql users with error: {}, retry in {}ms", code, delay);
+      this->pause(delay);
+      hydrated.clear();
+      missing.clear();
+      code = this->graphql_users(batch, hydrated, missing);
+    }
+    if (code != 0) {
+      spdlog::error("Request graphql users with error: {}, skip {} profiles", code, batch.size());
+      continue;
+    }
+    std::map<std::string, std::string> changes;
+    for (const User &user : hydrated) {
+      WRAP_FUNC(database->upsert_user(user))
+      changes[user.login] = user.updated_at;
+      int64_t depth = depths.contains(user.login) ? depths[user.login] : PRIORITY_SAMPLED_DEPTH;
+      this->discover_user(user, Priority::user(user, depth), depth);
+    }
+    this->revisit("users", changes);
+    graphql_users_counter.Increment(static_cast<double>(hydrated.size()));
+    rest.insert(rest.end(), missing.begin(), missing.end());
+    if (stopping) {
+      return EXIT_SUCCESS;
+    }
+  }
+
+  // the profiles left are tasks of their own, the idle workers fetch them alongside this one
+  return executor->fan_out("hydrate", rest.size(), [=, this](size_t i) {
+    if (stopping) {
+      return EXIT_SUCCESS;
+    }
+    RequestConfig request_config{
+        .host = this->default_url_prefix,
+        .path = "/users/" + rest[i],
+    };
+    request_config.extra.depth = depths.at(rest[i]);
+    int code = request(request_config, request_type_user, request_type_user);
+    if (code != 0) {
+      spdlog::error("Request userinfo with error: {}", code);
+      return code;
+    }
+    rest_users_counter.Increment();
+    return EXIT_SUCCESS;
+  });
+}
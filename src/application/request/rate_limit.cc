@@ -0,0 +1,30 @@
+#include <application/request.h>
+
+// /rate_limit is not counted to the rate limit, it initializes the budget of every token and resource
+int Request::startup_rate_limit() {
+  for (size_t i = 0; i < tokens->size(); i++) {
+    RequestConfig request_config{
+        .host = this->default_url_prefix,
+        .path = "/rate_limit",
+    };
+    FetchResponse response = fetcher->submit(this->prepare(request_config, static_cast<int>(i))).get();
+    if (response.status != 200) {
+      spdlog::error("Request rate limit of token {} got {}: {}", i, response.status, response.error);
+      continue;
+    }
+    try {
+      nlohmann::json content = nlohmann::json::parse(response.body);
+      for (const auto &it : content["resources"].items()) {
+        tokens->set(static_cast<int>(i), it.key(),
+                    it.value()["limit"].get<int64_t>(),
+                    it.value()["remaining"].get<int64_t>(),
+                    it.value()["reset"].get<int64_t>());
+      }
+      SPDLOG_INFO("Token {} rate limit: {}/{}", i, content["resources"][RESOURCE_CORE]["remaining"].get<int64_t>(),
+                  content["resources"][RESOURCE_CORE]["limit"].get<int64_t>());
+    } catch (const std::exception &e) {
+      spdlog::error("Parse rate limit of token {} with error: {}", i, e.what());
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -3,22 +3,85 @@
 Request::Request(Config c, Database *db) {
   config = std::move(c);
   database = db;
+  if (config.json_backend == JSON_BACKEND_SIMDJSON) {
+    decoder = new SimdDecoder();
+  } else {
+    decoder = new SaxDecoder();
+  }
+  fetcher = new Fetcher(config.pool_max_in_flight, config.pool_max_connections, config.pool_idle_timeout, config.pool_timeout * 1000);
+  tokens = new TokenScheduler(config.crawler_token, config.crawler_token_reserve);
+  if (config.crawler_token_chunk > 0) { // the replicas spend the budget of a token together
+    tokens->share(
+        [this](int index, const std::string &resource, int64_t window, int64_t cap, int64_t chunk) {
+          return database->reserve_token_budget(tokens->id(index), resource, window, cap, chunk);
+        },
+        config.crawler_token_chunk);
+  }
+  negatives = new NegativeCache();
+  pacer = new Pacer(config.crawler_sleep_each_request);
+  retry = new RetryPolicy(config.retry_max_attempts, config.retry_budget_ratio, config.retry_breaker_failures, config.retry_breaker_cooldown * 1000,
+                          config.retry_base_delay, config.retry_max_delay);
+  executor = new Executor(config.crawler_workers);
+  fair = new FairShare(config.crawler_share_slots * (config.crawler_token_lanes ? static_cast<int64_t>(tokens->size()) : 1), config.crawler_shares);
+  std::vector<Lane> token_lanes;
+  if (config.crawler_token_lanes) {
+    for (size_t i = 0; i < tokens->size(); i++) {
+      prometheus::Labels labels{{"lane", std::to_string(i)}};
+      token_lanes.push_back(Lane{
+          .fetcher = new Fetcher(config.pool_max_in_flight, config.pool_max_connections, config.pool_idle_timeout, config.pool_timeout * 1000, labels),
+          .pacer = new Pacer(config.crawler_sleep_each_request, labels),
+      });
+    }
+  }
+  lanes = new Lanes(tokens, Lane{.fetcher = fetcher, .pacer = pacer}, std::move(token_lanes));
 }
 
 Request::~Request() {
   stopping = true;
-  while (true) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(200)); // run loop
-    if (semaphore == 0) {
-      break;
-    }
+  tokens->stop();
+  fair->stop();
+  executor->stop();
+  if (info_thread.joinable()) {
+    info_thread.join();
+  }
+  if (events_thread.joinable()) {
+    events_thread.join();
+  }
+  if (search_thread.joinable()) {
+    search_thread.join();
+  }
+  if (lease_thread.joinable()) {
+    lease_thread.join();
+  }
+  if (!lease_owner.empty()) {
+    database->release_leases(lease_owner);
   }
 
+  delete executor;
+  for (auto &[queue, frontier] : frontiers) {
+    delete frontier;
+  }
+  delete lanes;
+  delete fetcher;
+  delete tokens;
+  delete decoder;
+  delete negatives;
+  delete retry;
+  delete pacer;
+  delete fair;
+
   SPDLOG_INFO("Spider stopped...");
 }
 
 int Request::startup() {
   SPDLOG_INFO("Spider is running...");
+  WRAP_FUNC(this->startup_rate_limit())
+  WRAP_FUNC(this->startup_frontier())
+  WRAP_FUNC(this->startup_lease())
+  for (const Negative &negative : database->list_negatives()) {
+    negatives->load(negative);
+  }
+
   RequestConfig request_config{
       .host = this->default_url_prefix,
       .path = "/users/" + config.crawler_entry_username,
@@ -30,25 +93,103 @@ int Request::startup() {
   }
 
   WRAP_FUNC(this->startup_followx())
+  WRAP_FUNC(this->startup_profiles())
   WRAP_FUNC(this->startup_info())
   WRAP_FUNC(this->startup_emojis())
   WRAP_FUNC(this->startup_orgs())
   WRAP_FUNC(this->startup_gitignore())
   WRAP_FUNC(this->startup_license())
   WRAP_FUNC(this->startup_xrepos())
+  WRAP_FUNC(this->startup_search())
+  WRAP_FUNC(this->startup_events())
   WRAP_FUNC(this->startup_repos_branches())
   WRAP_FUNC(this->startup_repos_branches_commits())
 
   return EXIT_SUCCESS;
 }
 
-int Request::request(RequestConfig &request_config, enum request_type type, enum request_type type_from, bool skip_sleep) {
-  if (this->stopping) {
-    return EXIT_SUCCESS;
-  }
+// crawl pops a batch of keys from the frontier of the queue, mostly of the highest priority bands, the
+// database is sampled when the frontier is drained. Each key is a task of the queue, the batch is committed
+// and the next one is taken when the last task of the batch is done.
+void Request::crawl(const std::string &queue, std::function<std::vector<std::string>()> sample, std::function<bool(const std::string &, RequestConfig &)> build, enum request_type type) {
+  executor->submit(queue, [=, this]() {
+    if (this->stopping) {
+      return;
+    }
+    PriorityFrontier *frontier = frontiers.contains(queue) ? frontiers.at(queue) : nullptr;
+    std::vector<FrontierEntry> entries;
+    if (frontier != nullptr) {
+      entries = frontier->pop(FRONTIER_BATCH);
+    }
+    bool popped = !entries.empty();
+    if (entries.empty()) {
+      for (const std::string &key : sample()) {
+        entries.push_back(FrontierEntry{.key = key, .depth = PRIORITY_SAMPLED_DEPTH, .score = PRIORITY_SAMPLED_SCORE});
+      }
+    }
+    std::vector<FrontierEntry> claimed;
+    if (int code = this->claim(queue, entries, claimed); code != 0) {
+      spdlog::error("Claim leases of {} with error: {}", queue, code);
+      if (popped) { // the batch is queued again and not committed, no key of it is lost
+        frontier->requeue(entries);
+      }
+      this->pause(1000);
+      this->crawl(queue, sample, build, type);
+      return;
+    }
+    std::vector<std::pair<std::string, RequestConfig>> batch;
+    for (const FrontierEntry &entry : claimed) {
+      RequestConfig request_config;
+      if (build(entry.key, request_config)) {
+        request_config.extra.depth = entry.depth;
+        request_config.extra.score = entry.score;
+        batch.emplace_back(entry.key, request_config);
+      } else { // a malformed key is not crawled, its lease must not be renewed forever
+        this->finish(queue, entry.key);
+      }
+    }
+    if (batch.empty()) {
+      if (frontier != nullptr) {
+        frontier->commit();
+      }
+      this->pause(1000);
+      // nothing is due and the pass is over, a key discovered in the meantime ends the wait
+      for (int64_t waited = 1; entries.empty() && waited < CRAWL_IDLE_PAUSE && !this->stopping && (frontier == nullptr || frontier->size() == 0); waited++) {
+        this->pause(1000);
+      }
+      this->crawl(queue, sample, build, type);
+      return;
+    }
+    auto left = std::make_shared<std::atomic<size_t>>(batch.size());
+    for (const auto &[key, entity] : batch) {
+      executor->submit(queue, [=, this]() {
+        if (!this->stopping) {
+          RequestConfig request_config = entity;
+          int code = request(request_config, type, type);
+          if (code != 0) {
+            spdlog::error("Request url: {} with error: {}", entity.path, code);
+          }
+          this->finish(queue, key);
+        }
+        if (--*left == 0) {
+          if (frontier != nullptr && !this->stopping) { // a batch cut by the shutdown is popped again after the restart
+            frontier->commit();
+          }
+          this->crawl(queue, sample, build, type);
+        }
+      });
+    }
+  });
+}
 
-  SPDLOG_INFO("Crawler url: {}{}", request_config.host, request_config.path);
+// pause sleeps in short steps, so the shutdown is not held by a long backoff
+void Request::pause(int64_t milliseconds) {
+  for (int64_t waited = 0; waited < milliseconds && !this->stopping; waited += 200) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(std::min<int64_t>(200, milliseconds - waited)));
+  }
+}
 
+FetchRequest Request::prepare(const RequestConfig &request_config, int token) {
   std::string _useragent = USERAGENT;
   if (!config.crawler_useragent.empty()) {
     _useragent = this->config.crawler_useragent;
@@ -63,219 +204,421 @@ int Request::request(RequestConfig &request_config, enum request_type type, enum
     url_prefix = this->default_url_prefix;
   }
 
-  std::string header_host = boost::algorithm::trim_left_copy_if(url_prefix, boost::is_any_of("https://"));
-  httplib::Client client(url_prefix.c_str());
-  httplib::Headers headers = {
-      {"Host", header_host},
-      {"User-Agent", _useragent},
-      {"Time-Zone", _timezone},
-      {"Authorization", "Bearer " + config.crawler_token[token_index]},
+  FetchRequest fetch_request{
+      .url = url_prefix + request_config.path,
+      .headers = {
+          {"User-Agent", _useragent},
+          {"Time-Zone", _timezone},
+          {"Authorization", "Bearer " + tokens->token(token)},
+      },
   };
 
   if (request_config.response_type == "" || request_config.response_type == "json") {
-    headers.insert(std::make_pair("Accept", "application/json"));
+    fetch_request.headers.insert(std::make_pair("Accept", "application/json"));
   }
+  return fetch_request;
+}
 
-  if (!skip_sleep) {
-    std::time_t now = std::time(0);
-    boost::random::mt19937 gen{static_cast<std::uint16_t>(now)};
-    boost::random::uniform_int_distribution<> sleep_random{0, static_cast<int>(config.crawler_sleep_each_request)};
-    std::this_thread::sleep_for(std::chrono::milliseconds(sleep_random(gen)));
+int Request::request(RequestConfig &request_config, enum request_type type, enum request_type type_from, bool skip_sleep) {
+  // the pages are walked in a loop, the stack must not grow with the thousands of pages of a list
+  while (!this->stopping) {
+    PageCursor cursor;
+    WRAP_FUNC(this->request_page(request_config, type, type_from, skip_sleep, cursor))
+    if (cursor.next.empty()) {
+      break;
+    }
+    if (cursor.last > link_page(cursor.next) && config.crawler_pages_in_flight > 1) {
+      return this->request_pages(request_config, cursor, type, type_from);
+    }
+    request_config.host = cursor.host;
+    request_config.path = cursor.next;
+    skip_sleep = false;
   }
+  return EXIT_SUCCESS;
+}
+
+// request_pages fetches the rest pages up to rel="last" concurrently, at most pages_in_flight of them,
+// the handlers get the pages in the order they arrive
+int Request::request_pages(const RequestConfig &request_config, const PageCursor &cursor, enum request_type type, enum request_type type_from) {
+  int64_t first = link_page(cursor.next);
+  int64_t workers = std::min<int64_t>(config.crawler_pages_in_flight, cursor.last - first + 1);
 
-  this->request_locker.lock();
+  auto page = std::make_shared<std::atomic<int64_t>>(first);
+  return executor->fan_out("pages", static_cast<size_t>(workers), [=, this](size_t) {
+    int failed = EXIT_SUCCESS;
+    while (!this->stopping) {
+      int64_t current = (*page)++;
+      if (current > cursor.last) {
+        break;
+      }
+      RequestConfig page_config = request_config;
+      page_config.host = cursor.host;
+      page_config.path = link_with_page(cursor.next, current);
+      PageCursor ignored;
+      int code = this->request_page(page_config, type, type_from, false, ignored);
+      if (code != 0) {
+        spdlog::error("Request url: {} with error: {}", page_config.path, code);
+        failed = REQUEST_ERROR;
+      }
+    }
+    return failed;
+  });
+}
+
+int Request::request_page(RequestConfig &request_config, enum request_type type, enum request_type type_from, bool skip_sleep, PageCursor &cursor) {
   if (this->stopping) {
     return EXIT_SUCCESS;
   }
-  httplib::Result response(nullptr, httplib::Error::Unknown, httplib::Headers{});
-  try {
-    response = client.Get(request_config.path.c_str(), headers);
-  } catch (const std::exception &e) {
-    this->request_locker.unlock();
-    spdlog::error("Request with error: {}, {}", request_config.path, e.what());
-    return REQUEST_ERROR;
+
+  SPDLOG_INFO("Crawler url: {}{}", request_config.host, request_config.path);
+
+  std::string url_prefix = request_config.host;
+  if (url_prefix.empty()) {
+    url_prefix = this->default_url_prefix;
+  }
+  std::string key = fmt::format("{}:{}{}", static_cast<int>(type), url_prefix, request_config.path);
+  bool shared = false;
+  PageResult result = pages.run(
+      key, [&, this]() {
+        PageResult page{.type_from = type_from};
+        page.code = this->fetch_page(request_config, type, type_from, skip_sleep, page);
+        return page;
+      },
+      shared);
+  cursor = result.cursor;
+  if (shared) {
+    // another thread fetched and stored the page, only its crawl version is left for this one
+    coalesced_counter.Increment();
+    if (result.code == 0 && result.type_from != type_from && !result.keys.empty()) {
+      int code = database->update_version(result.keys, type_from);
+      if (code != 0) {
+        spdlog::error("Database with error: {}", code);
+      }
+    }
   }
-  this->request_locker.unlock();
+  return result.code;
+}
 
-  if (this->stopping) {
+// fetch_page fetches the page with a conditional request and hands the body to the handler
+int Request::fetch_page(const RequestConfig &request_config, enum request_type type, enum request_type type_from, bool skip_sleep, PageResult &result) {
+  std::string entity_collection, entity_key;
+  bool entity_owned = NegativeCache::entity(request_config.path, entity_collection, entity_key);
+  if (negatives->dead(entity_collection, entity_key) || (!entity_owned && negatives->dead("", request_config.path))) {
     return EXIT_SUCCESS;
   }
 
-  if (response == nullptr) {
-    spdlog::error("Request with error: {}", request_config.path);
+  Etag etag;
+  FetchRequest fetch_request;
+  FetchResponse response;
+  std::string endpoint = RetryPolicy::endpoint(request_config.path);
+  std::string category = FairShare::category(type_from); // the hydration of a follower page is charged to followers
+  // the search api has a rate limit of its own, the scheduler paces it, the pacer spreads the core budget only
+  bool search_api = type == request_type_search_users || type == request_type_search_repos;
+  std::string resource = search_api ? RESOURCE_SEARCH : RESOURCE_CORE;
+  int64_t attempt = 0;
+  while (true) {
+    if (!retry->allow(endpoint)) {
+      spdlog::error("Circuit of {} is open, skip {}", endpoint, request_config.path);
+      return CIRCUIT_OPEN;
+    }
+
+    // a search waits for its budget before it takes a slot, the slot would be held for the minute of the search
+    // rate limit while the other crawl types wait for it
+    int token = -1;
+    if (search_api && (token = tokens->acquire(resource)) < 0) {
+      return EXIT_SUCCESS;
+    }
+
+    // the crawl types take turns by their shares, a slot is held until the response only
+    if (!fair->acquire(category)) {
+      if (token >= 0) {
+        tokens->release(token, resource);
+      }
+      return EXIT_SUCCESS;
+    }
+    if (!skip_sleep && !search_api && !lanes->split()) { // a lane paces its token after the token is picked
+      this->pause(lanes->reserve(-1));
+    }
+
+    // the token with the most budget left, blocks only if every token is drained until the earliest reset
+    if (!search_api && (token = tokens->acquire(resource)) < 0) {
+      fair->release();
+      return EXIT_SUCCESS;
+    }
+    Lane lane = lanes->lane(token); // the token has its own connections and pace, the lanes run side by side
+    if (lanes->split() && !skip_sleep && !search_api) {
+      this->pause(lanes->reserve(token));
+    }
+    fetch_request = this->prepare(request_config, token);
+
+    // conditional request, 304 is not counted to the rate limit
+    etag = database->get_etag(fetch_request.url);
+    if (!etag.etag.empty()) {
+      fetch_request.headers.insert(std::make_pair("If-None-Match", etag.etag));
+    }
+    if (!etag.last_modified.empty()) {
+      fetch_request.headers.insert(std::make_pair("If-Modified-Since", etag.last_modified));
+    }
+
+    // every crawler thread waits for its own transfer only, the fetcher keeps all of them in flight
+    auto start = std::chrono::steady_clock::now();
+    response = lane.fetcher->submit(fetch_request).get();
+    int64_t latency = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    fair->release();
+
+    if (response.status == 0) {
+      tokens->release(token, resource);
+    } else {
+      tokens->update(token, response.status, response.headers, resource);
+    }
+    if (this->stopping) {
+      return EXIT_SUCCESS;
+    }
+
+    enum retry_class retry_class = RetryPolicy::classify(response.status, response.headers, response.body);
+    retry->record(endpoint, retry_class);
+    lane.pacer->observe(retry_class == retry_secondary || retry_class == retry_server || retry_class == retry_transport, latency);
+    if (retry_class == retry_none) {
+      break;
+    }
+    if (retry_class == retry_primary) { // the scheduler does not hand out the drained token anymore
+      SPDLOG_INFO("Token {} is rate limited on {}, retry with another token", token, request_config.path);
+      continue;
+    }
+    int64_t delay = retry->backoff(retry_class, attempt++, response.headers);
+    if (delay < 0) {
+      break;
+    }
+    SPDLOG_INFO("Got {} on {}, retry in {}ms", response.status == 0 ? response.error : std::to_string(response.status), request_config.path, delay);
+    this->pause(delay);
+  }
+
+  if (response.status == 0) {
+    spdlog::error("Request with error: {}, {}", request_config.path, response.error);
     return REQUEST_ERROR;
   }
 
-  for (const auto &header : response->headers) {
-    if (header.first == "X-RateLimit-Limit") {
-      rate_limit_limit = std::stoi(header.second, nullptr);
-    } else if (header.first == "X-RateLimit-Reset") {
-      rate_limit_reset = std::stoi(header.second);
-    } else if (header.first == "X-RateLimit-Remaining") {
-      rate_limit_remaining = std::stoi(header.second);
-    }
+  if (this->stopping) {
+    return EXIT_SUCCESS;
   }
 
-  if (rate_limit_remaining % 10 == 0) {
-    SPDLOG_INFO("Rate limit: {}/{}", rate_limit_remaining, rate_limit_limit);
-    std::time_t result = rate_limit_reset;
-    char buffer[32];
-    std::strftime(buffer, 32, "%Y/%m/%d %H:%M:%S", std::localtime(&result));
-    SPDLOG_INFO("Rate limit reset at: {}", buffer);
+  std::string header_link;
+  auto it = response.headers.find("Link");
+  if (response.headers.end() != it && !it->second.empty()) {
+    header_link = it->second;
+  }
+  int64_t poll = 0;
+  it = response.headers.find("X-Poll-Interval");
+  if (response.headers.end() != it) {
+    poll = std::strtoll(it->second.c_str(), nullptr, 10);
   }
 
-  if (response->status == 403) {
-    auto now = std::chrono::system_clock::now();
-    auto current = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+  if (response.status == 304) {
+    // the stored entities are up to date, only refresh their crawl version
+    not_modified_counter.Increment();
+    if (!etag.keys.empty()) {
+      int code = type_from == request_type_user ? database->touch_users(etag.keys) : database->update_version(etag.keys, type_from);
+      if (code != 0) {
+        spdlog::error("Database with error: {}", code);
+      }
+    }
+    if (type_from == request_type_user) { // the profile did not change since the last visit
+      this->revisit(entity_collection, {{entity_key, ""}});
+    } else if (type == request_type_users_repos || type == request_type_orgs_repos) {
+      std::map<std::string, std::string> changes;
+      for (const std::string &key : etag.keys) { // name:owner
+        size_t colon = key.find(':');
+        if (colon != std::string::npos) {
+          changes[key.substr(colon + 1) + "/" + key.substr(0, colon)] = "";
+        }
+      }
+      this->revisit("repos", changes);
+    }
+    if (header_link.empty()) {
+      header_link = etag.link;
+    }
+    result.cursor = this->page_cursor(header_link);
+    result.cursor.poll = poll;
+    result.keys = etag.keys;
+    return EXIT_SUCCESS;
+  }
 
-    SPDLOG_INFO("Wait for another {}s to request due to rate limit, X-RateLimit-Reset: {}", rate_limit_reset - current, rate_limit_reset);
-    SPDLOG_INFO("Change token to next and retry");
-    token_index++;
-    token_index = token_index % config.crawler_token.size();
-    std::this_thread::sleep_for(std::chrono::milliseconds(this->sleep_for_another_token));
-    this->sleep_for_another_token *= 2;
-    if (this->sleep_for_another_token >= 30 * 1000 * 60 /* 30min */) {
-      this->sleep_for_another_token = 30 * 1000 * 60;
+  if (response.status == 404 || response.status == 410 || response.status == 451) {
+    // the entity is deleted or blocked, skip it and everything under it until the ttl passes. A missing
+    // sub-resource, a branch or a single issue, only skips its own path.
+    Negative negative{
+        .collection = entity_owned ? entity_collection : "",
+        .key = entity_owned ? entity_key : request_config.path,
+        .url = fetch_request.url,
+        .status = response.status,
+        .expire_at = std::time(nullptr) + config.crawler_negative_ttl,
+    };
+    negatives->put(negative);
+    int code = database->upsert_negative(negative);
+    if (code != 0) {
+      spdlog::error("Database with error: {}", code);
     }
-    return request(request_config, type, type_from);
+    SPDLOG_INFO("Got {} on request url: {}, skip {} {} for {}s", response.status, fetch_request.url, negative.collection, negative.key, config.crawler_negative_ttl);
+    return EXIT_SUCCESS;
   }
-  this->sleep_for_another_token = 1000;
 
-  if (response->status != 200) {
-    spdlog::error("Got {} on request url: {}{}, {}", response->status, request_config.host, request_config.path, response->body);
+  if (response.status != 200) {
+    spdlog::error("Got {} on request url: {}{}, {}", response.status, request_config.host, request_config.path, response.body);
     return REQUEST_ERROR;
   }
 
-  if (response->body.empty()) {
+  if (response.body.empty()) {
     return REQUEST_ERROR;
   }
 
+  result.cursor = this->page_cursor(header_link);
+  result.cursor.poll = poll;
   if (request_config.response_type == "" || request_config.response_type == "json") {
-    nlohmann::json content;
-    try {
-      content = nlohmann::json::parse(response->body);
-    } catch (const std::exception &e) {
-      spdlog::error("Parse json with error: {}, {}", request_config.path, e.what());
-      return REQUEST_ERROR;
-    }
-
-    try {
-      nlohmann::json::parser_callback_t cb =
-          [=](int /*depth*/, nlohmann::json::parse_event_t event, nlohmann::json &parsed) {
-            if (event == nlohmann::json::parse_event_t::key) {
-              std::string str = parsed.dump();
-              str.erase(str.begin(), str.begin() + 1);
-              str.erase(str.end() - 1, str.end());
-              if (boost::algorithm::ends_with(str, "_url") or str == "url") {
-                return false;
-              }
-            } else if (event == nlohmann::json::parse_event_t::value && parsed.dump() == "null") {
-              parsed = nlohmann::json("");
-              return true;
-            }
-            return true;
-          };
-      content = nlohmann::json::parse(response->body, cb);
-    } catch (nlohmann::detail::parse_error &e) {
-      spdlog::error("Request {} got error: {}", request_config.path, e.what());
-      return REQUEST_ERROR;
-    }
-
-    int code;
-    switch (type) {
-    case request_type_following:
-    case request_type_followers:
-      code = request_followx(content, type_from);
-      if (code != 0) {
-        spdlog::error("Request userinfo with error: {}", code);
-      }
-      break;
-    case request_type_orgs:
-      code = request_orgs(content, type_from);
-      if (code != 0) {
-        spdlog::error("Database with error: {}", code);
-      }
-      break;
-    case request_type_orgs_member:
-      code = request_orgs_members(content, type_from);
-      if (code != 0) {
-        spdlog::error("Database with error: {}", code);
-      }
-      break;
-    case request_type_user:
-      code = request_user(content, type_from);
-      if (code != 0) {
-        spdlog::error("Database with error: {}", code);
-      }
-      break;
-    case request_type_emoji:
-      code = request_emoji(content, type_from);
-      if (code != 0) {
-        spdlog::error("Database with error: {}", code);
-      }
-      break;
-    case request_type_gitignore_list:
-      code = request_gitignore_list(content, type_from);
-      if (code != 0) {
-        spdlog::error("Database with error: {}", code);
-      }
-      break;
-    case request_type_gitignore_info:
-      code = request_gitignore_info(content, type_from);
-      if (code != 0) {
-        spdlog::error("Database with error: {}", code);
-      }
-      break;
-    case request_type_license_list:
-      code = request_license_list(content, type_from);
-      if (code != 0) {
-        spdlog::error("Database with error: {}", code);
-      }
-      break;
-    case request_type_license_info:
-      code = request_license_info(content, type_from);
-      if (code != 0) {
-        spdlog::error("Database with error: {}", code);
-      }
-      break;
-    case request_type_orgs_repos:
-    case request_type_users_repos:
-      code = this->request_repo_list(content, type_from);
-      if (code != 0) {
-        spdlog::error("Database with error: {}", code);
-      }
-      break;
-    case request_type_users_repos_branches:
-      code = this->request_repo_branches(content, request_config.extra, type_from);
-      if (code != 0) {
-        spdlog::error("Database with error: {}", code);
-      }
-      break;
-    default:
-      SPDLOG_INFO("Unknown request type: {}", static_cast<int>(type));
-      return UNKNOWN_REQUEST_TYPE;
+    int code = this->handle(request_config, response.body, type, type_from, result);
+    if (code == JSON_PARSE_ERROR || code == UNKNOWN_REQUEST_TYPE) {
+      return code;
+    }
+    if (code == 0) {
+      this->save_etag(fetch_request.url, response, header_link, result.keys);
     }
   }
+  return EXIT_SUCCESS;
+}
 
-  std::regex pieces_regex(R"lit(<(https:\/\/api\.github\.com\/[0-9a-z\/\?_=&]+)>;\srel="(next|last|prev|first)")lit");
-  std::smatch result;
-  std::string header_link;
-  httplib::Headers::iterator it = response->headers.find("Link");
-  if (response->headers.end() != it && !it->second.empty()) {
-    header_link = it->second;
+// handle decodes the body and hands it to the handler of the type, the keys of the result get the crawl
+// version keys the handler writes, a 304 of the same url refreshes them without decoding the body again
+int Request::handle(const RequestConfig &request_config, const std::string &body, enum request_type type, enum request_type type_from, PageResult &result) {
+  int code;
+  switch (type) {
+  case request_type_following:
+  case request_type_followers:
+  case request_type_orgs_member: {
+    std::vector<User> users;
+    WRAP_FUNC(decoder->decode_users(body, users))
+    if (type == request_type_orgs_member) {
+      code = request_orgs_members(users, request_config.extra, type_from);
+    } else {
+      code = request_followx(users, request_config.extra, type_from);
+    }
+    if (code != 0) {
+      spdlog::error("Request userinfo with error: {}", code);
+    }
+    return code;
   }
-  while (!header_link.empty() && regex_search(header_link, result, pieces_regex)) {
-    if (result.size() == 3 && result[2] == "next") {
-      auto u = std::string(result[1]);
-      size_t pos = u.find(url_prefix);
-      if (pos != std::string::npos) {
-        u.erase(pos, url_prefix.length());
-      }
-      request_config.path = u;
-      return request(request_config, type, type_from);
+  case request_type_user: {
+    User user;
+    WRAP_FUNC(decoder->decode_user(body, user))
+    code = request_user(user, request_config.extra, type_from);
+    if (code != 0) {
+      spdlog::error("Database with error: {}", code);
+    }
+    result.keys.push_back(std::to_string(user.id));
+    return code;
+  }
+  case request_type_orgs: {
+    std::vector<Org> orgs;
+    WRAP_FUNC(decoder->decode_orgs(body, orgs))
+    code = request_orgs(orgs, request_config.extra, type_from);
+    if (code != 0) {
+      spdlog::error("Database with error: {}", code);
+    }
+    for (const Org &org : orgs) {
+      result.keys.push_back(std::to_string(org.id));
+    }
+    return code;
+  }
+  case request_type_orgs_repos:
+  case request_type_users_repos: {
+    std::vector<Repo> repos;
+    WRAP_FUNC(decoder->decode_repos(body, repos))
+    code = this->request_repo_list(repos, request_config.extra, type_from);
+    if (code != 0) {
+      spdlog::error("Database with error: {}", code);
+    }
+    for (const Repo &repo : repos) {
+      result.keys.push_back(fmt::format("{}:{}", repo.name, repo.owner));
+    }
+    return code;
+  }
+  case request_type_search_users:
+  case request_type_search_repos:
+    return this->request_search(request_config, body, type, type_from, result.cursor);
+  default:
+    break;
+  }
+
+  // the rest endpoints are small and rarely crawled, they keep the dom
+  nlohmann::json content;
+  WRAP_FUNC(this->parse(request_config, body, content))
+  switch (type) {
+  case request_type_emoji:
+    code = request_emoji(content, type_from);
+    break;
+  case request_type_gitignore_list:
+    code = request_gitignore_list(content, type_from);
+    break;
+  case request_type_gitignore_info:
+    code = request_gitignore_info(content, type_from);
+    break;
+  case request_type_license_list:
+    code = request_license_list(content, type_from);
+    break;
+  case request_type_license_info:
+    code = request_license_info(content, type_from);
+    if (content["key"].is_string()) {
+      result.keys.push_back(content["key"].get<std::string>());
     }
-    header_link = result.suffix().str();
+    break;
+  case request_type_users_repos_branches:
+    code = this->request_repo_branches(content, request_config.extra, type_from);
+    break;
+  case request_type_events:
+    code = this->request_events(content, request_config.extra, type_from);
+    break;
+  default:
+    SPDLOG_INFO("Unknown request type: {}", static_cast<int>(type));
+    return UNKNOWN_REQUEST_TYPE;
+  }
+  if (code != 0) {
+    spdlog::error("Database with error: {}", code);
   }
+  return code;
+}
 
+// parse drops the url fields and turns null into the empty string in one pass
+int Request::parse(const RequestConfig &request_config, const std::string &body, nlohmann::json &content) {
+  try {
+    nlohmann::json::parser_callback_t cb =
+        [](int /*depth*/, nlohmann::json::parse_event_t event, nlohmann::json &parsed) {
+          if (event == nlohmann::json::parse_event_t::key) {
+            const std::string &str = parsed.get_ref<const std::string &>();
+            if (boost::algorithm::ends_with(str, "_url") or str == "url") {
+              return false;
+            }
+          } else if (event == nlohmann::json::parse_event_t::value && parsed.is_null()) {
+            parsed = nlohmann::json("");
+          }
+          return true;
+        };
+    content = nlohmann::json::parse(body, cb);
+  } catch (const nlohmann::detail::parse_error &e) {
+    spdlog::error("Request {} got error: {}", request_config.path, e.what());
+    return JSON_PARSE_ERROR;
+  }
   return EXIT_SUCCESS;
 }
+
+PageCursor Request::page_cursor(const std::string &header_link) {
+  PageCursor cursor;
+  LinkHeader link = parse_link(header_link);
+  if (!link.next.empty()) {
+    std::string_view origin, path;
+    split_url(link.next, origin, path);
+    cursor.host = origin;
+    cursor.next = path;
+  }
+  if (!link.last.empty()) {
+    cursor.last = link_page(link.last);
+  }
+  return cursor;
+}
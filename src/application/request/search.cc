@@ -0,0 +1,107 @@
+#include <application/request.h>
+
+// startup_search walks all of the ranges again and again on a thread of its own, the new users and repos
+// are found by the next pass, a pass cut short by errors does not spin
+int Request::startup_search() {
+  std::vector<std::string> kinds;
+  if (config.crawler_type_search_users) {
+    kinds.push_back(SEARCH_USERS);
+  }
+  if (config.crawler_type_search_repos) {
+    kinds.push_back(SEARCH_REPOS);
+  }
+  if (kinds.empty()) {
+    return EXIT_SUCCESS;
+  }
+  search_thread = std::thread([this, kinds]() {
+    while (!this->stopping) {
+      int64_t today = std::chrono::floor<std::chrono::days>(std::chrono::system_clock::now()).time_since_epoch().count();
+      for (const std::string &kind : kinds) {
+        this->search(search_all(kind, today));
+      }
+      this->pause(SEARCH_PASS_PAUSE * 1000);
+    }
+  });
+  return EXIT_SUCCESS;
+}
+
+// search is one pass over the range, the ranges with more results than the search api returns are split
+// and walked after the others. SEARCH_MAX_IN_FLIGHT of them are fetched at the same time, each one holds
+// a worker until the search budget lets it go.
+void Request::search(const SearchRange &all) {
+  spdlog::info("Search of {} is starting...", all.kind);
+  std::deque<SearchRange> ranges{all};
+  while (!ranges.empty() && !this->stopping) {
+    std::vector<SearchRange> batch;
+    while (!ranges.empty() && batch.size() < SEARCH_MAX_IN_FLIGHT) {
+      batch.push_back(ranges.front());
+      ranges.pop_front();
+    }
+    std::vector<std::vector<SearchRange>> splits(batch.size());
+    executor->fan_out("search", batch.size(), [&](size_t i) { return this->search_range(batch[i], splits[i]); });
+    for (const std::vector<SearchRange> &split : splits) {
+      ranges.insert(ranges.end(), split.begin(), split.end());
+    }
+  }
+  spdlog::info("Search of {} is done", all.kind);
+}
+
+// search_range fetches the first page of the range, a range with more results than the search api returns
+// is split in two, the others are walked to the last page. The errors are logged, the pass goes on.
+int Request::search_range(const SearchRange &range, std::vector<SearchRange> &splits) {
+  if (this->stopping) {
+    return EXIT_SUCCESS;
+  }
+  enum request_type type = range.kind == SEARCH_USERS ? request_type_search_users : request_type_search_repos;
+  RequestConfig request_config{
+      .host = this->default_url_prefix,
+      .path = fmt::format("/search/{}?q={}&per_page=100", range.kind, search_query(range)),
+  };
+  request_config.extra.depth = PRIORITY_SAMPLED_DEPTH; // the hops from the entry user are unknown
+  PageCursor cursor;
+  SearchRange first, second;
+  int code = this->request_page(request_config, type, type, false, cursor);
+  if (code != 0) {
+    spdlog::error("Request url: {} with error: {}", request_config.path, code);
+  } else if (cursor.total > SEARCH_MAX_RESULTS && split_search(range, first, second)) {
+    search_split_counter.Increment();
+    splits.push_back(first);
+    splits.push_back(second);
+  } else {
+    while (!cursor.next.empty() && !this->stopping) { // the pages one by one, a fan-out would pass the cap
+      request_config.host = cursor.host;
+      request_config.path = cursor.next;
+      PageCursor next;
+      code = this->request_page(request_config, type, type, false, next);
+      if (code != 0) {
+        spdlog::error("Request url: {} with error: {}", request_config.path, code);
+        break;
+      }
+      cursor = next;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+// request_search hands the items of a search page to the handlers of the list pages, the total count
+// tells the caller whether the range has to be split
+int Request::request_search(const RequestConfig &request_config, const std::string &body, enum request_type type, enum request_type type_from, PageCursor &cursor) {
+  int code;
+  bool incomplete = false;
+  if (type == request_type_search_users) {
+    std::vector<User> users;
+    WRAP_FUNC(decoder->decode_search_users(body, users, cursor.total, incomplete))
+    code = this->request_users(users, request_config.extra, type_from);
+  } else {
+    std::vector<Repo> repos;
+    WRAP_FUNC(decoder->decode_search_repos(body, repos, cursor.total, incomplete))
+    code = this->request_repo_list(repos, request_config.extra, type_from);
+  }
+  if (incomplete) {
+    spdlog::warn("Search {} timed out, the results are incomplete", request_config.path);
+  }
+  if (code != 0) {
+    spdlog::error("Database with error: {}", code);
+  }
+  return code;
+}
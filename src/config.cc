@@ -1,4 +1,5 @@
 #include <config.h>
+#include <fair_share.h>
 
 int Config::initialize(const std::string &config_path) {
   try {
@@ -11,6 +12,16 @@ int Config::initialize(const std::string &config_path) {
     if (crawler_token.size() == 0 && token_env.size() > 0) {
       boost::algorithm::split(crawler_token, token_env, boost::algorithm::is_any_of(","));
     }
+    if (config["token_reserve"]) {
+      crawler_token_reserve = config["token_reserve"].as<int64_t>();
+    }
+    if (config["token_chunk"]) {
+      crawler_token_chunk = config["token_chunk"].as<int64_t>();
+    }
+    if (crawler_token_chunk < 0) {
+      spdlog::error("Config {0} has invalid token chunk: {1}", config_path, crawler_token_chunk);
+      return CONFIG_PARSE_ERROR;
+    }
     crawler_useragent = config["useragent"].as<std::string>();
     crawler_timezone = config["timezone"].as<std::string>();
     if (config["sleep_each_request"]) {
@@ -20,6 +31,73 @@ int Config::initialize(const std::string &config_path) {
       crawler_sleep_each_request = DEFAULT_SLEEP_EACH_REQUEST;
     }
 
+    if (config["json_backend"]) {
+      json_backend = config["json_backend"].as<std::string>();
+    }
+    if (json_backend != JSON_BACKEND_NLOHMANN && json_backend != JSON_BACKEND_SIMDJSON) {
+      spdlog::error("Config {0} has unknown json backend: {1}", config_path, json_backend);
+      return CONFIG_PARSE_ERROR;
+    }
+
+    auto pool = config["pool"];
+    if (pool) {
+      if (pool["max_connections"]) {
+        pool_max_connections = pool["max_connections"].as<int64_t>();
+      }
+      if (pool["max_in_flight"]) {
+        pool_max_in_flight = pool["max_in_flight"].as<int64_t>();
+      }
+      if (pool["idle_timeout"]) {
+        pool_idle_timeout = pool["idle_timeout"].as<int64_t>();
+      }
+      if (pool["timeout"]) {
+        pool_timeout = pool["timeout"].as<int64_t>();
+      }
+    }
+    if (pool_max_connections <= 0) {
+      pool_max_connections = DEFAULT_POOL_MAX_CONNECTIONS;
+    }
+    if (pool_max_in_flight <= 0) {
+      pool_max_in_flight = DEFAULT_POOL_MAX_IN_FLIGHT;
+    }
+    if (pool_timeout <= 0) {
+      pool_timeout = DEFAULT_POOL_TIMEOUT;
+    }
+
+    auto retry = config["retry"];
+    if (retry) {
+      if (retry["max_attempts"]) {
+        retry_max_attempts = retry["max_attempts"].as<int64_t>();
+      }
+      if (retry["budget_ratio"]) {
+        retry_budget_ratio = retry["budget_ratio"].as<double>();
+      }
+      if (retry["breaker_failures"]) {
+        retry_breaker_failures = retry["breaker_failures"].as<int64_t>();
+      }
+      if (retry["breaker_cooldown"]) {
+        retry_breaker_cooldown = retry["breaker_cooldown"].as<int64_t>();
+      }
+      if (retry["base_delay"]) {
+        retry_base_delay = retry["base_delay"].as<int64_t>();
+      }
+      if (retry["max_delay"]) {
+        retry_max_delay = retry["max_delay"].as<int64_t>();
+      }
+    }
+    if (retry_max_attempts < 0 || retry_budget_ratio < 0 || retry_breaker_failures < 0 || retry_breaker_cooldown < 0) {
+      spdlog::error("Config {0} has invalid retry: max_attempts {1}, budget_ratio {2}, breaker_failures {3}, breaker_cooldown {4}", config_path,
+                    retry_max_attempts, retry_budget_ratio, retry_breaker_failures, retry_breaker_cooldown);
+      return CONFIG_PARSE_ERROR;
+    }
+    if (retry_base_delay < 1 || retry_max_delay < retry_base_delay) {
+      spdlog::error("Config {0} has invalid retry delay: base {1}, max {2}", config_path, retry_base_delay, retry_max_delay);
+      return CONFIG_PARSE_ERROR;
+    }
+    if (retry_breaker_failures == 0) {
+      retry_breaker_failures = DEFAULT_RETRY_BREAKER_FAILURES;
+    }
+
     if (config["database"]) {
       if (config["database"]["type"]) {
         database_type = config["database"]["type"].as<std::string>();
@@ -73,6 +151,120 @@ int Config::initialize(const std::string &config_path) {
       if (crawler["license_list"]) {
         this->crawler_type_license_list = crawler["license_list"].as<bool>();
       }
+      if (crawler["search_users"]) {
+        this->crawler_type_search_users = crawler["search_users"].as<bool>();
+      }
+      if (crawler["search_repos"]) {
+        this->crawler_type_search_repos = crawler["search_repos"].as<bool>();
+      }
+      if (crawler["events"]) {
+        this->crawler_type_events = crawler["events"].as<bool>();
+      }
+      if (crawler["pages_in_flight"]) {
+        this->crawler_pages_in_flight = crawler["pages_in_flight"].as<int64_t>();
+      }
+      if (crawler["workers"]) {
+        this->crawler_workers = crawler["workers"].as<int64_t>();
+      }
+      if (crawler["token_lanes"]) {
+        this->crawler_token_lanes = crawler["token_lanes"].as<bool>();
+      }
+      if (crawler["share_slots"]) {
+        this->crawler_share_slots = crawler["share_slots"].as<int64_t>();
+      }
+      if (crawler["shares"]) {
+        for (const auto &it : crawler["shares"]) {
+          ShareConfig share;
+          if (it.second["weight"]) {
+            share.weight = it.second["weight"].as<double>();
+          }
+          if (it.second["min"]) {
+            share.min = it.second["min"].as<double>();
+          }
+          if (it.second["max_per_hour"]) {
+            share.max_per_hour = it.second["max_per_hour"].as<int64_t>();
+          }
+          this->crawler_shares[it.first.as<std::string>()] = share;
+        }
+      }
+      if (crawler["frontier_dir"]) {
+        this->crawler_frontier_dir = crawler["frontier_dir"].as<std::string>();
+      }
+      if (crawler["frontier_max"]) {
+        this->crawler_frontier_max = crawler["frontier_max"].as<int64_t>();
+      }
+      if (crawler["lease_ttl"]) {
+        this->crawler_lease_ttl = crawler["lease_ttl"].as<int64_t>();
+      }
+      if (crawler["lease_hold"]) {
+        this->crawler_lease_hold = crawler["lease_hold"].as<int64_t>();
+      }
+      if (crawler["negative_ttl"]) {
+        this->crawler_negative_ttl = crawler["negative_ttl"].as<int64_t>();
+      }
+      if (crawler["hydration"]) {
+        this->crawler_hydration = crawler["hydration"].as<std::string>();
+      }
+      if (crawler["profile_ttl"]) {
+        this->crawler_profile_ttl = crawler["profile_ttl"].as<int64_t>();
+      }
+      if (crawler["revisit_min"]) {
+        this->crawler_revisit_min = crawler["revisit_min"].as<int64_t>();
+      }
+      if (crawler["revisit_max"]) {
+        this->crawler_revisit_max = crawler["revisit_max"].as<int64_t>();
+      }
+    }
+
+    if (crawler_hydration != HYDRATION_GRAPHQL && crawler_hydration != HYDRATION_REST) {
+      spdlog::error("Config {0} has unknown hydration: {1}", config_path, crawler_hydration);
+      return CONFIG_PARSE_ERROR;
+    }
+
+    if (!crawler_shares.contains(PROFILES_QUEUE)) { // the profiles wait for the requests of the graph
+      crawler_shares[PROFILES_QUEUE] = ShareConfig{.weight = DEFAULT_PROFILES_WEIGHT};
+    }
+
+    double min_shares = 0;
+    for (const auto &[type, share] : crawler_shares) {
+      if (!FairShare::known(type)) {
+        spdlog::error("Config {0} has a share of unknown crawl type {1}", config_path, type);
+        return CONFIG_PARSE_ERROR;
+      }
+      if (share.weight <= 0 || share.min < 0 || share.max_per_hour < 0) {
+        spdlog::error("Config {0} has invalid share of {1}", config_path, type);
+        return CONFIG_PARSE_ERROR;
+      }
+      min_shares += share.min;
+    }
+    if (min_shares > 1) {
+      spdlog::error("Config {0} guarantees more than all of the requests: {1}", config_path, min_shares);
+      return CONFIG_PARSE_ERROR;
+    }
+
+    if (crawler_frontier_max < 1) {
+      spdlog::error("Config {0} has invalid frontier_max: {1}", config_path, crawler_frontier_max);
+      return CONFIG_PARSE_ERROR;
+    }
+
+    if (crawler_pages_in_flight < 1) {
+      spdlog::error("Config {0} has invalid pages_in_flight: {1}", config_path, crawler_pages_in_flight);
+      return CONFIG_PARSE_ERROR;
+    }
+
+    if (crawler_workers < 1) {
+      spdlog::error("Config {0} has invalid workers: {1}", config_path, crawler_workers);
+      return CONFIG_PARSE_ERROR;
+    }
+
+    if (crawler_lease_ttl < 0 || crawler_lease_hold < 0) {
+      spdlog::error("Config {0} has invalid lease: ttl {1}, hold {2}", config_path, crawler_lease_ttl, crawler_lease_hold);
+      return CONFIG_PARSE_ERROR;
+    }
+
+    if (crawler_revisit_min < 0 || crawler_revisit_max < 0 || (crawler_revisit_max > 0 && crawler_revisit_max < crawler_revisit_min)) {
+      spdlog::error("Config {0} has invalid revisit: min {1}, max {2}", config_path, crawler_revisit_min, crawler_revisit_max);
+      return CONFIG_PARSE_ERROR;
     }
 
     if (crawler_entry_username.empty() || crawler_token.empty()) {
@@ -7,5 +7,14 @@ int Mongo::create_collections() {
   WRAP_FUNC(this->create_x_collection("emojis", "name;url"))
   WRAP_FUNC(this->create_x_collection("gitignores", "name;source"))
   WRAP_FUNC(this->create_x_collection("licenses", "key;name"))
+  WRAP_FUNC(this->ensure_index("users", std::vector<std::string>{"x_upserted_at"}, false)) // the fresh and the stale profiles
+  WRAP_FUNC(this->ensure_index("etags", std::vector<std::string>{"url"}))
+  WRAP_FUNC(this->ensure_index("negatives", std::vector<std::string>{"collection", "key"}))
+  WRAP_FUNC(this->ensure_ttl_index("negatives", "expire_at"))
+  WRAP_FUNC(this->ensure_index("leases", std::vector<std::string>{"queue", "key"}))
+  WRAP_FUNC(this->ensure_ttl_index("leases", "expire_at"))
+  WRAP_FUNC(this->ensure_ttl_index("token_budgets", "expire_at"))
+  WRAP_FUNC(this->ensure_index("revisits", std::vector<std::string>{"collection", "key"}))
+  WRAP_FUNC(this->ensure_index("revisits", std::vector<std::string>{"collection", "next_at"}, false)) // the due ones
   return EXIT_SUCCESS;
 }
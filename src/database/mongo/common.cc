@@ -60,7 +60,7 @@ int Mongo::update_version(std::string key, enum request_type type) {
     GET_CONNECTION(this->uri->database(), "users")
     coll = database[fmt::format("{}_version", this->versions->to_string(type))];
 
-    bsoncxx::document::value record = make_document(kvp("key", key), kvp("version", version));
+    bsoncxx::document::value record = make_document(kvp("key", key), kvp("version", version), kvp("visited_at", bsoncxx::types::b_date(std::chrono::system_clock::now())));
     coll.update_one(make_document(kvp("key", key)), make_document(kvp("$set", record)), option);
   } catch (const std::exception &e) {
     spdlog::error("Something mongodb error occurred: {}", e.what());
@@ -70,15 +70,26 @@ int Mongo::update_version(std::string key, enum request_type type) {
 }
 
 int Mongo::update_version(std::vector<std::string> keys, enum request_type type) {
+  return this->pass_version(keys, type, true);
+}
+
+// pass_version moves the keys to the version of the crawl type, visited is false for the ones leaving the
+// pass without a visit, the time of their last visit is kept
+int Mongo::pass_version(const std::vector<std::string> &keys, enum request_type type, bool visited) {
   int64_t version = this->versions->get(type);
 
   try {
     GET_CONNECTION_RAW(this->uri->database())
     auto coll = database[fmt::format("{}_version", this->versions->to_string(type))];
     auto bulk = coll.create_bulk_write();
-    for (std::string key : keys) {
-      bsoncxx::document::value record = make_document(kvp("key", key), kvp("version", version));
-      mongocxx::model::update_one upsert_op{make_document(kvp("key", key)), make_document(kvp("$set", record))};
+    bsoncxx::types::b_date now(std::chrono::system_clock::now());
+    for (const std::string &key : keys) {
+      auto record = bsoncxx::builder::basic::document{};
+      record.append(kvp("key", key), kvp("version", version));
+      if (visited) {
+        record.append(kvp("visited_at", now));
+      }
+      mongocxx::model::update_one upsert_op{make_document(kvp("key", key)), make_document(kvp("$set", record.extract()))};
       upsert_op.upsert(true);
       bulk.append(upsert_op);
     }
@@ -114,11 +125,119 @@ int Mongo::incr_version(enum request_type type) {
   return EXIT_SUCCESS;
 }
 
+namespace {
+
+// join_keys joins the fields of the params of the document, false if one of them is not of its type
+bool join_keys(const bsoncxx::document::view &doc, const std::vector<std::string> &params, std::string &res) {
+  bool first = true;
+  for (const std::string &param : params) {
+    std::string s;
+    if (boost::algorithm::contains(param, VALUE_DELIMITER)) {
+      std::vector<std::string> param_list;
+      boost::algorithm::split(param_list, param, boost::algorithm::is_any_of(VALUE_DELIMITER));
+      if (param_list.size() != 2) {
+        spdlog::error("Something mongodb error occurred: {}", "parameter is not correct1");
+        return false;
+      }
+      auto doc_param = doc[param_list[0]];
+      if (param_list[1] == "string") {
+        s = doc_param.get_string().value;
+      } else if (param_list[1] == "int") {
+        s = std::to_string(doc_param.get_int64().value);
+      } else if (param_list[1] == "double") {
+        s = std::to_string(doc_param.get_double().value);
+      } else if (param_list[1] == "int64") {
+        s = std::to_string(doc_param.get_int64().value);
+      } else if (param_list[1] == "int32") {
+        s = std::to_string(doc_param.get_int32().value);
+      } else {
+        spdlog::error("Something mongodb error occurred, {}, type: {}", "parameter is not correct", param_list[1]);
+        return false;
+      }
+    } else {
+      auto doc_param = doc[param];
+      if (doc_param.type() == bsoncxx::type::k_utf8) {
+        s = doc_param.get_string().value;
+      } else {
+        spdlog::error("Something mongodb error occurred: {}", "parameter is not correct");
+        return false;
+      }
+    }
+    if (first) {
+      res = s;
+      first = false;
+    } else {
+      res += KEYS_DELIMITER + s;
+    }
+  }
+  return true;
+}
+
+// visited_at is the time in milliseconds the crawl type visited the entity of the looked up version, 0 if never
+int64_t visited_at(const bsoncxx::document::view &doc, const std::string &field) {
+  if (!doc[field] || doc[field].type() != bsoncxx::type::k_array) {
+    return 0;
+  }
+  for (auto &&version : doc[field].get_array().value) {
+    auto record = version.get_document().value;
+    if (record["visited_at"] && record["visited_at"].type() == bsoncxx::type::k_date) {
+      return record["visited_at"].get_date().to_int64();
+    }
+  }
+  return 0;
+}
+
+bool empty_array(const bsoncxx::document::view &doc, const std::string &field) {
+  return !doc[field] || doc[field].type() != bsoncxx::type::k_array || doc[field].get_array().value.empty();
+}
+
+} // namespace
+
+// lookup_keyed joins the documents of from, revisits or negatives, keyed by the collection and the local field
+bsoncxx::document::value Mongo::lookup_keyed(const std::string &from, const std::string &collection, const std::string &local, const std::string &as) {
+  auto same_collection = make_document(kvp("$eq", make_array("$collection", collection)));
+  auto same_key = make_document(kvp("$eq", make_array("$key", "$$key")));
+  return make_document(
+      kvp("from", from),
+      kvp("let", make_document(kvp("key", "$" + local))),
+      kvp("pipeline", make_array(
+                          make_document(kvp("$match", make_document(kvp("$expr", make_document(kvp("$and", make_array(same_collection, same_key))))))),
+                          make_document(kvp("$limit", 1)))),
+      kvp("as", as));
+}
+
+// due_revisits samples the keys of the collection whose next visit is due with the time it fell due in
+// milliseconds, the index of revisits on collection and next_at keeps it to the due ones
+std::map<std::string, int64_t> Mongo::due_revisits(const std::string &collection, int64_t limit) {
+  std::map<std::string, int64_t> due;
+  try {
+    GET_CONNECTION(this->uri->database(), "revisits")
+    bsoncxx::types::b_date now(std::chrono::system_clock::now());
+    mongocxx::pipeline stages;
+    stages.match(make_document(kvp("collection", collection), kvp("next_at", make_document(kvp("$lte", now)))));
+    stages.sample(limit);
+    stages.project(make_document(kvp("key", 1), kvp("next_at", 1)));
+    auto cursor = coll.aggregate(stages);
+    for (auto &&doc : cursor) {
+      due[std::string(doc["key"].get_string().value)] = doc["next_at"].get_date().to_int64();
+    }
+  } catch (const std::exception &e) {
+    spdlog::error("Something mongodb error occurred: {}", e.what());
+  }
+  return due;
+}
+
 // list_x_random
 // @params
 //    keys name:string;id:int64 代表获取 name 字段类型为 string, id 字段类型为 int64 的数据
-std::vector<std::string> Mongo::list_x_random(const std::string &collection, std::string keys, enum request_type type) {
+//    negative_key the field matched with the key of the negatives and the revisits, the dead entities are not sampled
+//    sort_key the field of the priority, a sample PRIORITY_SAMPLE_FACTOR times larger is cut to its top ones
+// An entity with a change history in revisits is sampled when its next visit is due, whichever pass the
+// crawl type is in, and once until it falls due again. The others are walked once a pass, the version of
+// the crawl type is increased when none of them is left.
+std::vector<std::string> Mongo::list_x_random(const std::string &collection, std::string keys, enum request_type type, const std::string &negative_key, const std::string &sort_key) {
   std::string type_string = this->versions->to_string(type);
+  std::string version_field = fmt::format("{}_version", type_string);
 
   std::vector<std::string> result;
 
@@ -129,84 +248,109 @@ std::vector<std::string> Mongo::list_x_random(const std::string &collection, std
     boost::algorithm::split(params, keys, boost::algorithm::is_any_of(KEYS_DELIMITER));
   }
 
-  mongocxx::pipeline stages;
-  stages.lookup(make_document(
-      kvp("from", fmt::format("{}_version", type_string)),
+  int64_t version = this->versions->get(type);
+  auto version_lookup = make_document(
+      kvp("from", version_field),
       kvp("localField", key),
       kvp("foreignField", "key"),
-      kvp("as", fmt::format("{}_version", type_string))));
-
-  int64_t version = this->versions->get(type);
-
-  bsoncxx::document::view_or_value filter1 = make_document(kvp(fmt::format("{}_version.version", type_string), make_document(kvp("$lt", version))));
-  bsoncxx::document::view_or_value filter2 = make_document(kvp(fmt::format("{}_version", type_string), make_document(kvp("$size", 0))));
-  stages.match(make_document(kvp("$or", make_array(filter1, filter2))));
-
-  stages.sample(this->sample_size);
+      kvp("as", version_field));
+  auto stale = make_document(kvp("$or", make_array(
+                                            make_document(kvp(version_field + ".version", make_document(kvp("$lt", version)))),
+                                            make_document(kvp(version_field, make_document(kvp("$size", 0)))))));
 
   mongocxx::options::aggregate option;
   option.max_time(std::chrono::milliseconds(5000));
 
-  try {
-    GET_CONNECTION(this->uri->database(), collection)
-    auto cursor = coll.aggregate(stages, option);
-    for (auto &&doc : cursor) {
-      std::string res;
-      bool first = true;
-      for (auto param : params) {
-        std::string s;
-        if (boost::algorithm::contains(param, VALUE_DELIMITER)) {
-          std::vector<std::string> param_list;
-          boost::algorithm::split(param_list, param, boost::algorithm::is_any_of(VALUE_DELIMITER));
-          if (param_list.size() != 2) {
-            spdlog::error("Something mongodb error occurred: {}", "parameter is not correct1");
-            return result;
-          }
-          auto doc_param = doc[param_list[0]];
-          if (param_list[1] == "string") {
-            s = doc_param.get_string().value;
-          } else if (param_list[1] == "int") {
-            s = std::to_string(doc_param.get_int64().value);
-          } else if (param_list[1] == "double") {
-            s = std::to_string(doc_param.get_double().value);
-          } else if (param_list[1] == "int64") {
-            s = std::to_string(doc_param.get_int64().value);
-          } else if (param_list[1] == "int32") {
-            s = std::to_string(doc_param.get_int32().value);
-          } else {
-            spdlog::error("Something mongodb error occurred, {}, type: {}", "parameter is not correct", param_list[1]);
-            return result;
-          }
-        } else {
-          auto doc_param = doc[param];
-          if (doc_param.type() == bsoncxx::type::k_utf8) {
-            s = doc_param.get_string().value;
-          } else {
-            spdlog::error("Something mongodb error occurred: {}", "parameter is not correct");
-            return result;
-          }
+  // the due entities first, the lookups run on the due ones only
+  std::map<std::string, int64_t> due;
+  if (!negative_key.empty()) {
+    due = this->due_revisits(collection, this->sample_size * PRIORITY_SAMPLE_FACTOR);
+  }
+  if (!due.empty()) {
+    auto in = bsoncxx::builder::basic::array{};
+    for (const auto &[due_key, next_at] : due) {
+      in.append(due_key);
+    }
+    mongocxx::pipeline stages;
+    stages.match(make_document(kvp(negative_key, make_document(kvp("$in", in)))));
+    stages.lookup(version_lookup.view());
+    stages.lookup(lookup_keyed("negatives", collection, negative_key, "x_negatives"));
+    if (!sort_key.empty()) {
+      stages.sort(make_document(kvp(sort_key, -1)));
+    }
+    try {
+      GET_CONNECTION(this->uri->database(), collection)
+      auto cursor = coll.aggregate(stages, option);
+      for (auto &&doc : cursor) {
+        std::string res;
+        if (result.size() >= static_cast<size_t>(this->sample_size) || !empty_array(doc, "x_negatives") || !join_keys(doc, params, res)) {
+          continue;
+        }
+        if (visited_at(doc, version_field) >= due[std::string(doc[negative_key].get_string().value)]) {
+          continue; // visited by the crawl type since it fell due, the next visit of the entity schedules it again
+        }
+        result.push_back(res);
+      }
+    } catch (const std::exception &e) {
+      spdlog::error("Something mongodb error occurred: {}", e.what());
+    }
+  }
+
+  // the entities without a change history of the pass, the sample is taken before the lookups. The scheduled
+  // and the dead ones of a sample leave the pass without a visit, so the next sample has fewer of them.
+  for (int round = 0; round < PRIORITY_SAMPLE_FACTOR && result.size() < static_cast<size_t>(this->sample_size); round++) {
+    mongocxx::pipeline stages;
+    stages.lookup(version_lookup.view());
+    stages.match(stale.view());
+    stages.sample(sort_key.empty() ? this->sample_size : this->sample_size * PRIORITY_SAMPLE_FACTOR);
+    if (!negative_key.empty()) {
+      stages.lookup(lookup_keyed("revisits", collection, negative_key, "x_revisits"));
+      stages.lookup(lookup_keyed("negatives", collection, negative_key, "x_negatives"));
+    }
+    if (!sort_key.empty()) {
+      stages.sort(make_document(kvp(sort_key, -1)));
+    }
+    size_t found = result.size();
+    bool sampled = false;
+    std::vector<std::string> skipped;
+    try {
+      GET_CONNECTION(this->uri->database(), collection)
+      auto cursor = coll.aggregate(stages, option);
+      for (auto &&doc : cursor) {
+        sampled = true;
+        std::string res;
+        if (!join_keys(doc, params, res)) {
+          return result;
         }
-        if (first) {
-          res = s;
-          first = false;
-        } else {
-          res += KEYS_DELIMITER + s;
+        if (!empty_array(doc, "x_revisits") || !empty_array(doc, "x_negatives")) {
+          skipped.push_back(res);
+        } else if (result.size() < static_cast<size_t>(this->sample_size)) {
+          result.push_back(res);
         }
       }
-      result.push_back(res);
+    } catch (const std::exception &e) {
+      spdlog::error("Something mongodb error occurred: {}", e.what());
+      break;
+    }
+    if (!skipped.empty()) {
+      this->pass_version(skipped, type, false);
     }
-    if (result.empty()) {
+    if (!sampled) { // the pass is over, the next sample starts the next one
       this->incr_version(type);
-    } else {
-      this->update_version(result, type);
+      break;
+    }
+    if (result.size() > found) {
+      break;
     }
-  } catch (const std::exception &e) {
-    spdlog::error("Something mongodb error occurred: {}", e.what());
+  }
+
+  if (!result.empty()) {
+    this->update_version(result, type);
   }
   return result;
 }
 
-int Mongo::ensure_index(const std::string &collection, std::vector<std::string> keys) {
+int Mongo::ensure_index(const std::string &collection, std::vector<std::string> keys, bool unique) {
   try {
     std::string name = fmt::format("{}_index", boost::algorithm::join(keys, "_"));
     GET_CONNECTION(this->uri->database(), collection)
@@ -218,7 +362,7 @@ int Mongo::ensure_index(const std::string &collection, std::vector<std::string>
       }
     }
     mongocxx::options::index index_options{};
-    index_options.unique(true);
+    index_options.unique(unique);
     index_options.name(name);
     auto doc = bsoncxx::builder::basic::document{};
     for (const auto &key : keys) {
@@ -237,6 +381,30 @@ int Mongo::ensure_index(const std::string &collection, std::vector<std::string>
   return EXIT_SUCCESS;
 }
 
+// ensure_ttl_index removes the documents once the date in key is passed
+int Mongo::ensure_ttl_index(const std::string &collection, const std::string &key) {
+  try {
+    std::string name = fmt::format("{}_ttl_index", key);
+    GET_CONNECTION(this->uri->database(), collection)
+    auto cursor = coll.list_indexes();
+    for (auto &&doc : cursor) {
+      if (doc["name"].get_string().value == name) {
+        spdlog::info("Collection {} index {} already exists", collection, name);
+        return EXIT_SUCCESS;
+      }
+    }
+    mongocxx::options::index index_options{};
+    index_options.name(name);
+    index_options.expire_after(std::chrono::seconds(0));
+    coll.create_index(make_document(kvp(key, 1)), index_options);
+    spdlog::info("Collection {} create index {} success", collection, name);
+  } catch (const std::exception &e) {
+    spdlog::error("Something mongodb error occurred: {}", e.what());
+    return SQL_EXEC_ERROR;
+  }
+  return EXIT_SUCCESS;
+}
+
 std::string bson_type(std::string str) {
   if (str == "string") {
     return "string";
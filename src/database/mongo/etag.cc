@@ -0,0 +1,42 @@
+#include <database/mongo.h>
+
+int Mongo::upsert_etag(Etag etag) {
+  bsoncxx::types::b_date now(std::chrono::system_clock::now());
+  auto keys = bsoncxx::builder::basic::array{};
+  for (const auto &key : etag.keys) {
+    keys.append(key);
+  }
+  bsoncxx::document::value doc = make_document(
+      kvp("url", etag.url),
+      kvp("etag", etag.etag),
+      kvp("last_modified", etag.last_modified),
+      kvp("link", etag.link),
+      kvp("keys", keys.view()),
+      kvp("x_upserted_at", now));
+  bsoncxx::document::value filter = make_document(kvp("url", etag.url));
+  return this->upsert_x("etags", bsoncxx::to_json(filter), bsoncxx::to_json(doc));
+}
+
+Etag Mongo::get_etag(std::string url) {
+  Etag etag;
+  try {
+    GET_CONNECTION(this->uri->database(), "etags")
+    auto result = coll.find_one(make_document(kvp("url", url)));
+    if (!result) {
+      return etag;
+    }
+    auto view = result->view();
+    etag.url = url;
+    etag.etag = std::string(view["etag"].get_string().value);
+    etag.last_modified = std::string(view["last_modified"].get_string().value);
+    etag.link = std::string(view["link"].get_string().value);
+    if (view["keys"] && view["keys"].type() == bsoncxx::type::k_array) {
+      for (auto &&key : view["keys"].get_array().value) {
+        etag.keys.push_back(std::string(key.get_string().value));
+      }
+    }
+  } catch (const std::exception &e) {
+    spdlog::error("Something mongodb error occurred: {}", e.what());
+  }
+  return etag;
+}
@@ -0,0 +1,32 @@
+#include <database/mongo.h>
+
+// advance_events raises the newest event id with one atomic $max and returns the id before it, so of the
+// replicas polling the same page only the one raising the id applies its events, and a restart does not
+// apply them again
+int64_t Mongo::advance_events(int64_t last) {
+  mongocxx::options::find_one_and_update options;
+  options.upsert(true);
+  options.return_document(mongocxx::options::return_document::k_before);
+  for (int attempt = 0; attempt < 2; attempt++) { // two replicas creating the cursor at once, one of the upserts fails
+    try {
+      GET_CONNECTION(this->uri->database(), "cursors")
+      auto doc = coll.find_one_and_update(
+          make_document(kvp("_id", "events")),
+          make_document(kvp("$max", make_document(kvp("last", last)))),
+          options);
+      if (!doc) {
+        return 0;
+      }
+      return doc->view()["last"].get_int64().value;
+    } catch (const mongocxx::operation_exception &e) {
+      if (attempt > 0 || e.code().value() != 11000) {
+        spdlog::error("Something mongodb error occurred: {}", e.what());
+        return -1;
+      }
+    } catch (const std::exception &e) {
+      spdlog::error("Something mongodb error occurred: {}", e.what());
+      return -1;
+    }
+  }
+  return -1;
+}
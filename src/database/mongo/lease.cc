@@ -0,0 +1,131 @@
+#include <database/mongo.h>
+
+namespace {
+
+bsoncxx::types::b_date lease_date(int64_t seconds) {
+  return bsoncxx::types::b_date(std::chrono::system_clock::now() + std::chrono::seconds(seconds));
+}
+
+// duplicates returns true if the bulk write failed on duplicate keys only, the leases of the other replicas
+bool duplicates(const mongocxx::bulk_write_exception &e) {
+  if (!e.raw_server_error()) {
+    return false;
+  }
+  bsoncxx::document::view reply = e.raw_server_error()->view();
+  auto concern = reply["writeConcernErrors"];
+  if (concern && concern.type() == bsoncxx::type::k_array && !concern.get_array().value.empty()) {
+    return false;
+  }
+  auto errors = reply["writeErrors"];
+  if (!errors || errors.type() != bsoncxx::type::k_array || errors.get_array().value.empty()) {
+    return false;
+  }
+  for (auto &&error : errors.get_array().value) {
+    auto code = error["code"];
+    if (!code || code.type() != bsoncxx::type::k_int32 || code.get_int32().value != 11000) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+// claim_leases upserts the lease of each key that is free, expired or already held by the owner, the
+// lease of another replica fails the upsert on the unique index of queue and key, then the keys the
+// owner holds are read back
+int Mongo::claim_leases(const std::string &queue, const std::vector<std::string> &keys, const std::string &owner, int64_t ttl, std::vector<std::string> &claimed) {
+  if (keys.empty()) {
+    return EXIT_SUCCESS;
+  }
+  try {
+    GET_CONNECTION(this->uri->database(), "leases")
+    bsoncxx::types::b_date now = lease_date(0);
+    bsoncxx::types::b_date expire_at = lease_date(ttl);
+    mongocxx::options::bulk_write bulk_options;
+    bulk_options.ordered(false);
+    auto bulk = coll.create_bulk_write(bulk_options);
+    auto in = bsoncxx::builder::basic::array{};
+    for (const std::string &key : keys) {
+      bsoncxx::document::value filter = make_document(
+          kvp("queue", queue),
+          kvp("key", key),
+          kvp("$or", make_array(
+                         make_document(kvp("expire_at", make_document(kvp("$lt", now)))),
+                         make_document(kvp("owner", owner), kvp("state", "active")))));
+      bsoncxx::document::value doc = make_document(
+          kvp("queue", queue),
+          kvp("key", key),
+          kvp("owner", owner),
+          kvp("state", "active"),
+          kvp("expire_at", expire_at));
+      mongocxx::model::update_one upsert_op{filter.view(), make_document(kvp("$set", doc))};
+      upsert_op.upsert(true);
+      bulk.append(upsert_op);
+      in.append(key);
+    }
+    try {
+      bulk.execute();
+    } catch (const mongocxx::bulk_write_exception &e) {
+      if (!duplicates(e)) {
+        throw;
+      }
+      spdlog::debug("Leases of {} held by other replicas: {}", queue, e.what());
+    }
+    auto cursor = coll.find(make_document(
+        kvp("queue", queue),
+        kvp("key", make_document(kvp("$in", in))),
+        kvp("owner", owner),
+        kvp("state", "active")));
+    std::set<std::string> held;
+    for (auto &&doc : cursor) {
+      held.insert(std::string(doc["key"].get_string().value));
+    }
+    for (const std::string &key : keys) {
+      if (held.contains(key)) {
+        claimed.push_back(key);
+      }
+    }
+  } catch (const std::exception &e) {
+    spdlog::error("Something mongodb error occurred: {}", e.what());
+    claimed.clear();
+    return SQL_EXEC_ERROR;
+  }
+  return EXIT_SUCCESS;
+}
+
+int Mongo::renew_leases(const std::string &owner, int64_t ttl) {
+  try {
+    GET_CONNECTION(this->uri->database(), "leases")
+    coll.update_many(make_document(kvp("owner", owner), kvp("state", "active")),
+                     make_document(kvp("$set", make_document(kvp("expire_at", lease_date(ttl))))));
+  } catch (const std::exception &e) {
+    spdlog::error("Something mongodb error occurred: {}", e.what());
+    return SQL_EXEC_ERROR;
+  }
+  return EXIT_SUCCESS;
+}
+
+int Mongo::finish_lease(const std::string &queue, const std::string &key, const std::string &owner, int64_t hold) {
+  try {
+    GET_CONNECTION(this->uri->database(), "leases")
+    coll.update_one(make_document(kvp("queue", queue), kvp("key", key), kvp("owner", owner)),
+                    make_document(kvp("$set", make_document(kvp("state", "done"), kvp("expire_at", lease_date(hold))))));
+  } catch (const std::exception &e) {
+    spdlog::error("Something mongodb error occurred: {}", e.what());
+    return SQL_EXEC_ERROR;
+  }
+  return EXIT_SUCCESS;
+}
+
+// release_leases frees the keys the owner has not crawled yet, the other replicas take them at once
+int Mongo::release_leases(const std::string &owner) {
+  try {
+    GET_CONNECTION(this->uri->database(), "leases")
+    coll.delete_many(make_document(kvp("owner", owner), kvp("state", "active")));
+  } catch (const std::exception &e) {
+    spdlog::error("Something mongodb error occurred: {}", e.what());
+    return SQL_EXEC_ERROR;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,36 @@
+#include <database/mongo.h>
+
+int Mongo::upsert_negative(Negative negative) {
+  bsoncxx::types::b_date now(std::chrono::system_clock::now());
+  bsoncxx::types::b_date expire_at{std::chrono::system_clock::time_point(std::chrono::seconds(negative.expire_at))};
+  bsoncxx::document::value doc = make_document(
+      kvp("collection", negative.collection),
+      kvp("key", negative.key),
+      kvp("url", negative.url),
+      kvp("status", negative.status),
+      kvp("expire_at", expire_at),
+      kvp("x_upserted_at", now));
+  bsoncxx::document::value filter = make_document(kvp("collection", negative.collection), kvp("key", negative.key));
+  return this->upsert_x("negatives", bsoncxx::to_json(filter), bsoncxx::to_json(doc));
+}
+
+std::vector<Negative> Mongo::list_negatives() {
+  std::vector<Negative> negatives;
+  try {
+    GET_CONNECTION(this->uri->database(), "negatives")
+    bsoncxx::types::b_date now(std::chrono::system_clock::now());
+    auto cursor = coll.find(make_document(kvp("expire_at", make_document(kvp("$gt", now)))));
+    for (auto &&doc : cursor) {
+      negatives.push_back(Negative{
+          .collection = std::string(doc["collection"].get_string().value),
+          .key = std::string(doc["key"].get_string().value),
+          .url = std::string(doc["url"].get_string().value),
+          .status = doc["status"].get_int32().value,
+          .expire_at = std::chrono::duration_cast<std::chrono::seconds>(doc["expire_at"].get_date().value).count(),
+      });
+    }
+  } catch (const std::exception &e) {
+    spdlog::error("Something mongodb error occurred: {}", e.what());
+  }
+  return negatives;
+}
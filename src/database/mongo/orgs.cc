@@ -42,7 +42,7 @@ int Mongo::upsert_org_with_version(std::vector<Org> orgs, enum request_type type
 }
 
 std::vector<std::string> Mongo::list_orgs_random(enum request_type type) {
-  return this->list_x_random("orgs", "login", type);
+  return this->list_x_random("orgs", "login", type, "login");
 }
 
 int64_t Mongo::count_org() {
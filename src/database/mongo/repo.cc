@@ -58,8 +58,74 @@ int Mongo::upsert_repo_with_version(std::vector<Repo> repos, enum request_type t
   return EXIT_SUCCESS;
 }
 
+// touch_repos moves the pushed_at of a repo forward and adds the new stars and forks to its counts, the
+// next crawl of the repo writes the exact values
+int Mongo::touch_repos(const std::vector<RepoActivity> &repos) {
+  if (repos.empty()) {
+    return EXIT_SUCCESS;
+  }
+  try {
+    GET_CONNECTION(this->uri->database(), "repos")
+    mongocxx::options::bulk_write bulk_options;
+    bulk_options.ordered(false);
+    auto bulk = coll.create_bulk_write(bulk_options);
+    size_t operations = 0;
+    for (const RepoActivity &repo : repos) {
+      bsoncxx::document::value filter = make_document(kvp("name", repo.name), kvp("owner", repo.owner));
+      if (!repo.pushed_at.empty()) {
+        bsoncxx::document::value pushed = make_document(
+            kvp("name", repo.name),
+            kvp("owner", repo.owner),
+            kvp("pushed_at", make_document(kvp("$lt", repo.pushed_at)))); // the iso dates sort as strings
+        bulk.append(mongocxx::model::update_one{pushed.view(), make_document(kvp("$set", make_document(kvp("pushed_at", repo.pushed_at))))});
+        operations++;
+      }
+      if (repo.stars != 0 || repo.forks != 0) {
+        bsoncxx::document::value inc = make_document(
+            kvp("stargazers_count", repo.stars),
+            kvp("watchers_count", repo.stars),
+            kvp("watchers", repo.stars),
+            kvp("forks_count", repo.forks),
+            kvp("forks", repo.forks));
+        bulk.append(mongocxx::model::update_one{filter.view(), make_document(kvp("$inc", inc))});
+        operations++;
+      }
+    }
+    if (operations > 0) { // a bulk write without operations throws
+      bulk.execute();
+    }
+  } catch (const std::exception &e) {
+    spdlog::error("Something mongodb error occurred: {}", e.what());
+    return SQL_EXEC_ERROR;
+  }
+  return EXIT_SUCCESS;
+}
+
+Repo Mongo::get_repo(const std::string &owner, const std::string &name) {
+  Repo repo{};
+  try {
+    GET_CONNECTION(this->uri->database(), "repos")
+    auto result = coll.find_one(make_document(kvp("name", name), kvp("owner", owner)));
+    if (!result) {
+      return repo;
+    }
+    auto view = result->view();
+    repo.owner = owner;
+    repo.name = name;
+    repo.pushed_at = std::string(view["pushed_at"].get_string().value);
+    repo.stargazers_count = view["stargazers_count"].get_int64().value;
+    repo.watchers_count = view["watchers_count"].get_int64().value;
+    repo.watchers = view["watchers"].get_int64().value;
+    repo.forks_count = view["forks_count"].get_int64().value;
+    repo.forks = view["forks"].get_int64().value;
+  } catch (const std::exception &e) {
+    spdlog::error("Something mongodb error occurred: {}", e.what());
+  }
+  return repo;
+}
+
 std::vector<std::string> Mongo::list_repos_random(enum request_type type) {
-  return this->list_x_random("repos", "name;owner", type);
+  return this->list_x_random("repos", "name;owner", type, "full_name", "stargazers_count");
 }
 
 int64_t Mongo::count_repo() {
@@ -0,0 +1,53 @@
+#include <database/mongo.h>
+
+int Mongo::observe_revisits(const std::string &collection, const std::map<std::string, std::string> &changes, int64_t min, int64_t max) {
+  if (changes.empty()) {
+    return EXIT_SUCCESS;
+  }
+  try {
+    GET_CONNECTION(this->uri->database(), "revisits")
+    auto in = bsoncxx::builder::basic::array{};
+    for (const auto &[key, changed_at] : changes) {
+      in.append(key);
+    }
+    std::map<std::string, Revisit> revisits;
+    auto cursor = coll.find(make_document(kvp("collection", collection), kvp("key", make_document(kvp("$in", in)))));
+    for (auto &&doc : cursor) {
+      Revisit revisit;
+      revisit.last_change = doc["last_change"].get_string().value;
+      revisit.visited_at = doc["visited_at"].get_int64().value;
+      revisit.visits = doc["visits"].get_double().value;
+      revisit.changes = doc["changes"].get_double().value;
+      revisit.observed = doc["observed"].get_double().value;
+      revisits[std::string(doc["key"].get_string().value)] = revisit;
+    }
+
+    int64_t now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    mongocxx::options::bulk_write bulk_options;
+    bulk_options.ordered(false);
+    auto bulk = coll.create_bulk_write(bulk_options);
+    for (const auto &[key, changed_at] : changes) {
+      Revisit &revisit = revisits[key];
+      revisit_observe(revisit, changed_at, now, min, max);
+      bsoncxx::document::value filter = make_document(kvp("collection", collection), kvp("key", key));
+      bsoncxx::document::value doc = make_document(
+          kvp("collection", collection),
+          kvp("key", key),
+          kvp("last_change", revisit.last_change),
+          kvp("visited_at", revisit.visited_at),
+          kvp("visits", revisit.visits),
+          kvp("changes", revisit.changes),
+          kvp("observed", revisit.observed),
+          kvp("rate", revisit.rate),
+          kvp("next_at", bsoncxx::types::b_date(std::chrono::system_clock::time_point(std::chrono::seconds(revisit.next_at)))));
+      mongocxx::model::update_one upsert_op{filter.view(), make_document(kvp("$set", doc))};
+      upsert_op.upsert(true);
+      bulk.append(upsert_op);
+    }
+    bulk.execute();
+  } catch (const std::exception &e) {
+    spdlog::error("Something mongodb error occurred: {}", e.what());
+    return SQL_EXEC_ERROR;
+  }
+  return EXIT_SUCCESS;
+}
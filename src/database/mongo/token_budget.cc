@@ -0,0 +1,37 @@
+#include <database/mongo.h>
+
+// reserve_token_budget adds the chunk to the requests granted of the token and window with one atomic $inc,
+// the replicas racing for the last chunk share what is left below the cap, the ones after them get nothing
+int64_t Mongo::reserve_token_budget(const std::string &token, const std::string &resource, int64_t window, int64_t cap, int64_t chunk) {
+  std::string id = fmt::format("{}:{}:{}", token, resource, window);
+  bsoncxx::types::b_date expire_at{std::chrono::system_clock::time_point(std::chrono::seconds(window + 3600))};
+  mongocxx::options::find_one_and_update options;
+  options.upsert(true);
+  options.return_document(mongocxx::options::return_document::k_after);
+  for (int attempt = 0; attempt < 2; attempt++) { // two replicas creating the window at once, one of the upserts fails
+    try {
+      GET_CONNECTION(this->uri->database(), "token_budgets")
+      auto doc = coll.find_one_and_update(
+          make_document(kvp("_id", id)),
+          make_document(
+              kvp("$inc", make_document(kvp("granted", chunk))),
+              kvp("$set", make_document(kvp("token", token), kvp("resource", resource), kvp("window", window), kvp("cap", cap), kvp("expire_at", expire_at)))),
+          options);
+      if (!doc) {
+        return 0;
+      }
+      int64_t granted = doc->view()["granted"].get_int64().value;
+      int64_t before = granted - chunk;
+      return std::clamp<int64_t>(cap - before, 0, chunk);
+    } catch (const mongocxx::operation_exception &e) {
+      if (attempt > 0 || e.code().value() != 11000) {
+        spdlog::error("Something mongodb error occurred: {}", e.what());
+        return -1;
+      }
+    } catch (const std::exception &e) {
+      spdlog::error("Something mongodb error occurred: {}", e.what());
+      return -1;
+    }
+  }
+  return -1;
+}
@@ -31,6 +31,120 @@ int Mongo::upsert_user_with_version(User user, enum request_type type) {
   return EXIT_SUCCESS;
 }
 
+int Mongo::upsert_user_stub(const std::vector<User> &users) {
+  if (users.empty()) {
+    return EXIT_SUCCESS;
+  }
+  bsoncxx::types::b_date now(std::chrono::system_clock::now());
+  std::map<std::string, std::string> filters;
+  for (const User &user : users) {
+    auto doc = bsoncxx::builder::basic::document{};
+    doc.append(kvp("id", user.id), kvp("login", user.login), kvp("x_discovered_at", now));
+    if (!user.node_id.empty()) { // the actor of an event has no node_id and type, the stored ones are kept
+      doc.append(kvp("node_id", user.node_id));
+    }
+    if (!user.type.empty()) {
+      doc.append(kvp("type", user.type));
+    }
+    bsoncxx::document::value filter = make_document(kvp("id", user.id));
+    filters[bsoncxx::to_json(filter)] = bsoncxx::to_json(doc.view());
+  }
+  return this->upsert_x("users", filters);
+}
+
+// the profile is fresh if upsert_user wrote it after now - ttl, a stub has no x_upserted_at
+std::vector<User> Mongo::list_users_fresh(const std::vector<std::string> &logins, int64_t ttl) {
+  std::vector<User> fresh;
+  if (logins.empty()) {
+    return fresh;
+  }
+  try {
+    GET_CONNECTION(this->uri->database(), "users")
+    bsoncxx::types::b_date since(std::chrono::system_clock::now() - std::chrono::seconds(ttl));
+    auto in = bsoncxx::builder::basic::array{};
+    for (const std::string &login : logins) {
+      in.append(login);
+    }
+    mongocxx::options::find options;
+    options.projection(make_document(kvp("login", 1), kvp("followers", 1), kvp("public_repos", 1)));
+    auto cursor = coll.find(make_document(
+                                kvp("login", make_document(kvp("$in", in))),
+                                kvp("x_upserted_at", make_document(kvp("$gte", since)))),
+                            options);
+    for (auto &&doc : cursor) {
+      User user{.login = std::string(doc["login"].get_string().value)};
+      if (doc["followers"] && doc["followers"].type() == bsoncxx::type::k_int64) {
+        user.followers = doc["followers"].get_int64().value;
+      }
+      if (doc["public_repos"] && doc["public_repos"].type() == bsoncxx::type::k_int64) {
+        user.public_repos = doc["public_repos"].get_int64().value;
+      }
+      fresh.push_back(user);
+    }
+  } catch (const std::exception &e) {
+    spdlog::error("Something mongodb error occurred: {}", e.what());
+  }
+  return fresh;
+}
+
+// list_users_stale samples the profiles due again by their change history, then the stubs and the profiles
+// without a change history fetched before now - ttl. Sampled, a dead user stays stale and would come first
+// again and again.
+std::vector<std::string> Mongo::list_users_stale(int64_t ttl) {
+  std::vector<std::string> stale;
+  std::set<std::string> seen;
+  for (const auto &[login, next_at] : this->due_revisits("users", this->sample_size)) {
+    stale.push_back(login);
+    seen.insert(login);
+  }
+  if (stale.size() >= static_cast<size_t>(this->sample_size)) {
+    return stale;
+  }
+  try {
+    GET_CONNECTION(this->uri->database(), "users")
+    bsoncxx::types::b_date since(std::chrono::system_clock::now() - std::chrono::seconds(ttl));
+    auto stub = make_document(kvp("x_upserted_at", make_document(kvp("$exists", false))));
+    mongocxx::pipeline stages; // the index on x_upserted_at narrows the match, the lookup runs on the sample only
+    stages.match(make_document(kvp("$or", make_array(stub.view(), make_document(kvp("x_upserted_at", make_document(kvp("$lt", since))))))));
+    stages.sample(this->sample_size - static_cast<int32_t>(stale.size()));
+    stages.lookup(lookup_keyed("revisits", "users", "login", "x_revisits"));
+    // a profile with a change history waits until its next visit is due, the ttl covers the rest
+    stages.match(make_document(kvp("$or", make_array(stub.view(), make_document(kvp("x_revisits", make_document(kvp("$size", 0))))))));
+    stages.project(make_document(kvp("login", 1)));
+    auto cursor = coll.aggregate(stages);
+    for (auto &&doc : cursor) {
+      std::string login(doc["login"].get_string().value);
+      if (seen.insert(login).second) {
+        stale.push_back(login);
+      }
+    }
+  } catch (const std::exception &e) {
+    spdlog::error("Something mongodb error occurred: {}", e.what());
+  }
+  return stale;
+}
+
+// touch_users marks the profiles answered with 304 as fresh
+int Mongo::touch_users(const std::vector<std::string> &ids) {
+  if (ids.empty()) {
+    return EXIT_SUCCESS;
+  }
+  try {
+    GET_CONNECTION(this->uri->database(), "users")
+    auto in = bsoncxx::builder::basic::array{};
+    for (const std::string &id : ids) {
+      in.append(static_cast<int64_t>(std::stoll(id)));
+    }
+    bsoncxx::types::b_date now(std::chrono::system_clock::now());
+    coll.update_many(make_document(kvp("id", make_document(kvp("$in", in)))),
+                     make_document(kvp("$set", make_document(kvp("x_upserted_at", now)))));
+  } catch (const std::exception &e) {
+    spdlog::error("Something mongodb error occurred: {}", e.what());
+    return SQL_EXEC_ERROR;
+  }
+  return EXIT_SUCCESS;
+}
+
 std::vector<User> Mongo::list_usersx(common_args args) {
   std::vector<User> users;
   try {
@@ -46,7 +160,7 @@ std::vector<User> Mongo::list_usersx(common_args args) {
 }
 
 std::vector<std::string> Mongo::list_users_random(enum request_type type) {
-  return this->list_x_random("users", "login", type);
+  return this->list_x_random("users", "login", type, "login", "followers");
 }
 
 int64_t Mongo::count_user() {
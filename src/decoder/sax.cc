@@ -0,0 +1,221 @@
+#include <decoder/sax.h>
+
+namespace {
+
+class UserSax : public ModelSax<User> {
+protected:
+  void set(User &user, std::string_view parent, std::string_view key, const std::string &value) override {
+    if (!parent.empty()) {
+      return;
+    }
+    if (key == "login") {
+      user.login = value;
+    } else if (key == "node_id") {
+      user.node_id = value;
+    } else if (key == "type") {
+      user.type = value;
+    } else if (key == "name") {
+      user.name = value;
+    } else if (key == "company") {
+      user.company = value;
+    } else if (key == "blog") {
+      user.blog = value;
+    } else if (key == "location") {
+      user.location = value;
+    } else if (key == "email") {
+      user.email = value;
+    } else if (key == "bio") {
+      user.bio = value;
+    } else if (key == "created_at") {
+      user.created_at = value;
+    } else if (key == "updated_at") {
+      user.updated_at = value;
+    }
+  }
+
+  void set(User &user, std::string_view parent, std::string_view key, int64_t value) override {
+    if (!parent.empty()) {
+      return;
+    }
+    if (key == "id") {
+      user.id = value;
+    } else if (key == "public_gists") {
+      user.public_gists = value;
+    } else if (key == "public_repos") {
+      user.public_repos = value;
+    } else if (key == "following") {
+      user.following = value;
+    } else if (key == "followers") {
+      user.followers = value;
+    }
+  }
+
+  void set(User &user, std::string_view parent, std::string_view key, bool value) override {
+    if (parent.empty() && key == "hireable") {
+      user.hireable = value;
+    }
+  }
+
+public:
+  using ModelSax<User>::ModelSax;
+};
+
+class RepoSax : public ModelSax<Repo> {
+protected:
+  void set(Repo &repo, std::string_view parent, std::string_view key, const std::string &value) override {
+    if (parent == "owner") {
+      if (key == "login") {
+        repo.owner = value;
+      } else if (key == "type") {
+        repo.owner_type = value;
+      }
+      return;
+    }
+    if (parent == "license") {
+      if (key == "key") {
+        repo.license = value;
+      }
+      return;
+    }
+    if (!parent.empty()) {
+      return;
+    }
+    if (key == "node_id") {
+      repo.node_id = value;
+    } else if (key == "name") {
+      repo.name = value;
+    } else if (key == "full_name") {
+      repo.full_name = value;
+    } else if (key == "description") {
+      repo.description = value;
+    } else if (key == "created_at") {
+      repo.created_at = value;
+    } else if (key == "updated_at") {
+      repo.updated_at = value;
+    } else if (key == "pushed_at") {
+      repo.pushed_at = value;
+    } else if (key == "homepage") {
+      repo.homepage = value;
+    } else if (key == "language") {
+      repo.language = value;
+    } else if (key == "default_branch") {
+      repo.default_branch = value;
+    }
+  }
+
+  void set(Repo &repo, std::string_view parent, std::string_view key, int64_t value) override {
+    if (!parent.empty()) {
+      return;
+    }
+    if (key == "id") {
+      repo.id = value;
+    } else if (key == "size") {
+      repo.size = value;
+    } else if (key == "stargazers_count") {
+      repo.stargazers_count = value;
+    } else if (key == "watchers_count") {
+      repo.watchers_count = value;
+    } else if (key == "forks_count") {
+      repo.forks_count = value;
+    } else if (key == "forks") {
+      repo.forks = value;
+    } else if (key == "open_issues") {
+      repo.open_issues = value;
+    } else if (key == "watchers") {
+      repo.watchers = value;
+    }
+  }
+
+  void set(Repo &repo, std::string_view parent, std::string_view key, bool value) override {
+    if (!parent.empty()) {
+      return;
+    }
+    if (key == "private") {
+      repo.xprivate = value;
+    } else if (key == "fork") {
+      repo.fork = value;
+    }
+  }
+
+public:
+  using ModelSax<Repo>::ModelSax;
+};
+
+class OrgSax : public ModelSax<Org> {
+protected:
+  void set(Org &org, std::string_view parent, std::string_view key, const std::string &value) override {
+    if (!parent.empty()) {
+      return;
+    }
+    if (key == "login") {
+      org.login = value;
+    } else if (key == "node_id") {
+      org.node_id = value;
+    } else if (key == "description") {
+      org.description = value;
+    }
+  }
+
+  void set(Org &org, std::string_view parent, std::string_view key, int64_t value) override {
+    if (parent.empty() && key == "id") {
+      org.id = value;
+    }
+  }
+
+public:
+  using ModelSax<Org>::ModelSax;
+};
+
+template <class Sax>
+int sax_parse(const std::string &body, Sax &sax) {
+  bool ok = nlohmann::json::sax_parse(body, &sax, nlohmann::json::input_format_t::json, false);
+  if (!ok) {
+    spdlog::error("Parse json with error: {}", sax.error);
+    return JSON_PARSE_ERROR;
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int SaxDecoder::decode_user(const std::string &body, User &user) {
+  std::vector<User> users;
+  UserSax sax(users, 1);
+  WRAP_FUNC(sax_parse(body, sax))
+  if (users.empty()) {
+    return JSON_PARSE_ERROR;
+  }
+  user = std::move(users.front());
+  return EXIT_SUCCESS;
+}
+
+int SaxDecoder::decode_users(const std::string &body, std::vector<User> &users) {
+  UserSax sax(users, 2);
+  return sax_parse(body, sax);
+}
+
+int SaxDecoder::decode_repos(const std::string &body, std::vector<Repo> &repos) {
+  RepoSax sax(repos, 2);
+  return sax_parse(body, sax);
+}
+
+int SaxDecoder::decode_orgs(const std::string &body, std::vector<Org> &orgs) {
+  OrgSax sax(orgs, 2);
+  return sax_parse(body, sax);
+}
+
+int SaxDecoder::decode_search_users(const std::string &body, std::vector<User> &users, int64_t &total, bool &incomplete) {
+  UserSax sax(users, 3);
+  WRAP_FUNC(sax_parse(body, sax))
+  total = sax.total;
+  incomplete = sax.incomplete;
+  return EXIT_SUCCESS;
+}
+
+int SaxDecoder::decode_search_repos(const std::string &body, std::vector<Repo> &repos, int64_t &total, bool &incomplete) {
+  RepoSax sax(repos, 3);
+  WRAP_FUNC(sax_parse(body, sax))
+  total = sax.total;
+  incomplete = sax.incomplete;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,270 @@
+#include <decoder/simd.h>
+
+using namespace simdjson;
+
+namespace {
+
+// null and the values of another type leave the value initialized field as it is, the same as the sax decoder
+void get(ondemand::value &value, std::string &out) {
+  if (value.type() == ondemand::json_type::string) {
+    out = std::string_view(value.get_string());
+  }
+}
+
+void get(ondemand::value &value, int64_t &out) {
+  if (value.type() != ondemand::json_type::number) {
+    return;
+  }
+  switch (value.get_number_type()) {
+  case ondemand::number_type::signed_integer:
+    out = value.get_int64();
+    break;
+  case ondemand::number_type::unsigned_integer:
+    out = static_cast<int64_t>(uint64_t(value.get_uint64()));
+    break;
+  default:
+    break;
+  }
+}
+
+void get(ondemand::value &value, bool &out) {
+  if (value.type() == ondemand::json_type::boolean) {
+    out = value.get_bool();
+  }
+}
+
+void decode(ondemand::object object, User &user) {
+  for (ondemand::field field : object) {
+    std::string_view key = field.unescaped_key();
+    ondemand::value value = field.value();
+    if (key == "login") {
+      get(value, user.login);
+    } else if (key == "id") {
+      get(value, user.id);
+    } else if (key == "node_id") {
+      get(value, user.node_id);
+    } else if (key == "type") {
+      get(value, user.type);
+    } else if (key == "name") {
+      get(value, user.name);
+    } else if (key == "company") {
+      get(value, user.company);
+    } else if (key == "blog") {
+      get(value, user.blog);
+    } else if (key == "location") {
+      get(value, user.location);
+    } else if (key == "email") {
+      get(value, user.email);
+    } else if (key == "hireable") {
+      get(value, user.hireable);
+    } else if (key == "bio") {
+      get(value, user.bio);
+    } else if (key == "created_at") {
+      get(value, user.created_at);
+    } else if (key == "updated_at") {
+      get(value, user.updated_at);
+    } else if (key == "public_gists") {
+      get(value, user.public_gists);
+    } else if (key == "public_repos") {
+      get(value, user.public_repos);
+    } else if (key == "following") {
+      get(value, user.following);
+    } else if (key == "followers") {
+      get(value, user.followers);
+    }
+  }
+}
+
+void decode(ondemand::object object, Repo &repo) {
+  for (ondemand::field field : object) {
+    std::string_view key = field.unescaped_key();
+    ondemand::value value = field.value();
+    if (key == "id") {
+      get(value, repo.id);
+    } else if (key == "node_id") {
+      get(value, repo.node_id);
+    } else if (key == "name") {
+      get(value, repo.name);
+    } else if (key == "full_name") {
+      get(value, repo.full_name);
+    } else if (key == "private") {
+      get(value, repo.xprivate);
+    } else if (key == "owner") {
+      if (value.type() != ondemand::json_type::object) {
+        continue;
+      }
+      for (ondemand::field owner : value.get_object()) {
+        std::string_view owner_key = owner.unescaped_key();
+        ondemand::value owner_value = owner.value();
+        if (owner_key == "login") {
+          get(owner_value, repo.owner);
+        } else if (owner_key == "type") {
+          get(owner_value, repo.owner_type);
+        }
+      }
+    } else if (key == "description") {
+      get(value, repo.description);
+    } else if (key == "fork") {
+      get(value, repo.fork);
+    } else if (key == "created_at") {
+      get(value, repo.created_at);
+    } else if (key == "updated_at") {
+      get(value, repo.updated_at);
+    } else if (key == "pushed_at") {
+      get(value, repo.pushed_at);
+    } else if (key == "homepage") {
+      get(value, repo.homepage);
+    } else if (key == "size") {
+      get(value, repo.size);
+    } else if (key == "stargazers_count") {
+      get(value, repo.stargazers_count);
+    } else if (key == "watchers_count") {
+      get(value, repo.watchers_count);
+    } else if (key == "forks_count") {
+      get(value, repo.forks_count);
+    } else if (key == "language") {
+      get(value, repo.language);
+    } else if (key == "license") {
+      if (value.type() != ondemand::json_type::object) {
+        continue;
+      }
+      for (ondemand::field license : value.get_object()) {
+        std::string_view license_key = license.unescaped_key();
+        ondemand::value license_value = license.value();
+        if (license_key == "key") {
+          get(license_value, repo.license);
+        }
+      }
+    } else if (key == "forks") {
+      get(value, repo.forks);
+    } else if (key == "open_issues") {
+      get(value, repo.open_issues);
+    } else if (key == "watchers") {
+      get(value, repo.watchers);
+    } else if (key == "default_branch") {
+      get(value, repo.default_branch);
+    }
+  }
+}
+
+void decode(ondemand::object object, Org &org) {
+  for (ondemand::field field : object) {
+    std::string_view key = field.unescaped_key();
+    ondemand::value value = field.value();
+    if (key == "id") {
+      get(value, org.id);
+    } else if (key == "login") {
+      get(value, org.login);
+    } else if (key == "node_id") {
+      get(value, org.node_id);
+    } else if (key == "description") {
+      get(value, org.description);
+    }
+  }
+}
+
+ondemand::parser &thread_parser() {
+  thread_local ondemand::parser parser;
+  return parser;
+}
+
+template <class T>
+int decode_list(const std::string &body, std::vector<T> &items) {
+  try {
+    padded_string json(body);
+    ondemand::document doc = thread_parser().iterate(json);
+    for (ondemand::value item : doc.get_array()) {
+      if (item.type() != ondemand::json_type::object) {
+        continue;
+      }
+      T &t = items.emplace_back();
+      decode(item.get_object(), t);
+    }
+    if (!doc.at_end()) {
+      spdlog::error("Parse json with error: trailing content");
+      return JSON_PARSE_ERROR;
+    }
+  } catch (const simdjson_error &e) {
+    spdlog::error("Parse json with error: {}", e.what());
+    return JSON_PARSE_ERROR;
+  }
+  return EXIT_SUCCESS;
+}
+
+// decode_search walks the items of a search page in place, the page is not parsed a second time
+template <class T>
+int decode_search(const std::string &body, std::vector<T> &items, int64_t &total, bool &incomplete) {
+  try {
+    padded_string json(body);
+    ondemand::document doc = thread_parser().iterate(json);
+    total = -1;
+    incomplete = false;
+    for (ondemand::field field : doc.get_object()) {
+      std::string_view key = field.unescaped_key();
+      ondemand::value value = field.value();
+      if (key == "total_count") {
+        get(value, total);
+      } else if (key == "incomplete_results") {
+        get(value, incomplete);
+      } else if (key == "items") {
+        if (value.type() != ondemand::json_type::array) {
+          continue;
+        }
+        for (ondemand::value item : value.get_array()) {
+          if (item.type() != ondemand::json_type::object) {
+            continue;
+          }
+          T &t = items.emplace_back();
+          decode(item.get_object(), t);
+        }
+      }
+    }
+    if (!doc.at_end()) {
+      spdlog::error("Parse json with error: trailing content");
+      return JSON_PARSE_ERROR;
+    }
+  } catch (const simdjson_error &e) {
+    spdlog::error("Parse json with error: {}", e.what());
+    return JSON_PARSE_ERROR;
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int SimdDecoder::decode_user(const std::string &body, User &user) {
+  try {
+    padded_string json(body);
+    ondemand::document doc = thread_parser().iterate(json);
+    user = User{};
+    decode(doc.get_object(), user);
+    if (!doc.at_end()) {
+      spdlog::error("Parse json with error: trailing content");
+      return JSON_PARSE_ERROR;
+    }
+  } catch (const simdjson_error &e) {
+    spdlog::error("Parse json with error: {}", e.what());
+    return JSON_PARSE_ERROR;
+  }
+  return EXIT_SUCCESS;
+}
+
+int SimdDecoder::decode_users(const std::string &body, std::vector<User> &users) {
+  return decode_list(body, users);
+}
+
+int SimdDecoder::decode_repos(const std::string &body, std::vector<Repo> &repos) {
+  return decode_list(body, repos);
+}
+
+int SimdDecoder::decode_orgs(const std::string &body, std::vector<Org> &orgs) {
+  return decode_list(body, orgs);
+}
+
+int SimdDecoder::decode_search_users(const std::string &body, std::vector<User> &users, int64_t &total, bool &incomplete) {
+  return decode_search(body, users, total, incomplete);
+}
+
+int SimdDecoder::decode_search_repos(const std::string &body, std::vector<Repo> &repos, int64_t &total, bool &incomplete) {
+  return decode_search(body, repos, total, incomplete);
+}
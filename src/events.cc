@@ -0,0 +1,112 @@
+#include <events.h>
+
+namespace {
+
+// json_field is null for a missing key, the const operator[] of nlohmann asserts on it
+const nlohmann::json &json_field(const nlohmann::json &object, const std::string &key) {
+  static const nlohmann::json missing;
+  if (object.is_object()) {
+    auto it = object.find(key);
+    if (it != object.end()) {
+      return *it;
+    }
+  }
+  return missing;
+}
+
+std::string json_string(const nlohmann::json &object, const std::string &key) {
+  const nlohmann::json &field = json_field(object, key);
+  return field.is_string() ? field.get<std::string>() : "";
+}
+
+// repos_queue is the crawl type that lists the repos of the owner of the event
+std::pair<std::string, std::string> repos_queue(const nlohmann::json &event, const std::string &owner) {
+  std::string org = json_string(json_field(event, "org"), "login");
+  if (!org.empty()) {
+    return {"orgs_repos", org};
+  }
+  return {"users_repos", owner};
+}
+
+void add_user(const nlohmann::json &object, std::set<int64_t> &seen, std::vector<User> &users) {
+  std::string login = json_string(object, "login");
+  const nlohmann::json &id = json_field(object, "id");
+  if (login.empty() || !id.is_number_integer() || login.ends_with("[bot]")) { // a bot has no graph to crawl
+    return;
+  }
+  User user{};
+  user.id = id.get<int64_t>();
+  user.login = login;
+  user.node_id = json_string(object, "node_id"); // the actor of an event has neither of them
+  user.type = json_string(object, "type");
+  if (seen.insert(user.id).second) {
+    users.push_back(user);
+  }
+}
+
+} // namespace
+
+EventActions event_actions(const nlohmann::json &events, int64_t after) {
+  EventActions actions;
+  if (!events.is_array()) {
+    return actions;
+  }
+  std::set<int64_t> seen;
+  for (const nlohmann::json &event : events) {
+    int64_t id;
+    try {
+      id = std::stoll(json_string(event, "id"));
+    } catch (const std::exception &) {
+      continue;
+    }
+    if (id <= after) {
+      continue;
+    }
+    actions.last = std::max(actions.last, id);
+    actions.count++;
+
+    add_user(json_field(event, "actor"), seen, actions.users);
+    std::string full_name = json_string(json_field(event, "repo"), "name");
+    size_t slash = full_name.find('/');
+    if (slash == std::string::npos) {
+      continue;
+    }
+    std::string owner = full_name.substr(0, slash);
+    std::string name = full_name.substr(slash + 1);
+    std::string repo_key = name + KEYS_DELIMITER + owner;
+    std::string type = json_string(event, "type");
+    const nlohmann::json &payload = json_field(event, "payload");
+
+    if (type == "PushEvent") {
+      actions.repos.push_back(RepoActivity{.owner = owner, .name = name, .pushed_at = json_string(event, "created_at")});
+      actions.recrawls.emplace("users_repos_branches", repo_key);
+      std::string ref = json_string(payload, "ref");
+      if (ref.starts_with("refs/heads/")) {
+        actions.recrawls.emplace("users_repos_branches_commits", repo_key + KEYS_DELIMITER + ref.substr(11));
+      }
+    } else if (type == "CreateEvent" || type == "DeleteEvent") {
+      std::string ref_type = json_string(payload, "ref_type");
+      if (ref_type == "branch") {
+        actions.recrawls.emplace("users_repos_branches", repo_key);
+      } else if (ref_type == "repository") {
+        actions.recrawls.insert(repos_queue(event, owner));
+      }
+    } else if (type == "WatchEvent") {
+      actions.repos.push_back(RepoActivity{.owner = owner, .name = name, .stars = 1});
+    } else if (type == "ForkEvent") {
+      actions.repos.push_back(RepoActivity{.owner = owner, .name = name, .forks = 1});
+      const nlohmann::json &fork = json_field(json_field(payload, "forkee"), "owner");
+      std::string fork_owner = json_string(fork, "login");
+      if (fork_owner.empty()) {
+        fork_owner = json_string(json_field(event, "actor"), "login");
+      }
+      bool fork_org = json_string(fork, "type") == "Organization";
+      actions.recrawls.emplace(fork_org ? "orgs_repos" : "users_repos", fork_owner);
+    } else if (type == "PublicEvent") {
+      actions.recrawls.insert(repos_queue(event, owner));
+    } else if (type == "MemberEvent") {
+      add_user(json_field(payload, "member"), seen, actions.users);
+    }
+  }
+  return actions;
+}
@@ -0,0 +1,178 @@
+#include <executor.h>
+
+namespace {
+thread_local const Executor *current_executor = nullptr;
+thread_local size_t current_worker = 0;
+} // namespace
+
+Executor::Executor(int64_t count) {
+  if (count < 1) {
+    count = 1;
+  }
+  for (int64_t i = 0; i < count; i++) {
+    workers.emplace_back(std::make_unique<Worker>());
+  }
+  for (int64_t i = 0; i < count; i++) {
+    threads.emplace_back([this, i] { this->loop(static_cast<size_t>(i)); });
+  }
+}
+
+Executor::~Executor() {
+  this->stop();
+}
+
+void Executor::depth(const std::string &queue, int64_t delta) {
+  std::lock_guard<std::mutex> lock(depth_locker);
+  int64_t &d = depths[queue];
+  d += delta;
+  Metrics::gauge("spider_executor_queue_depth", "Crawl tasks waiting for a worker", {{"queue", queue}}).Set(static_cast<double>(d));
+}
+
+int64_t Executor::depth(const std::string &queue) {
+  std::lock_guard<std::mutex> lock(depth_locker);
+  auto it = depths.find(queue);
+  return it == depths.end() ? 0 : it->second;
+}
+
+size_t Executor::size() const {
+  return workers.size();
+}
+
+void Executor::submit(const std::string &queue, std::function<void()> run) {
+  size_t index;
+  if (current_executor == this) {
+    index = current_worker;
+  } else {
+    index = next++ % workers.size();
+  }
+  {
+    std::lock_guard<std::mutex> lock(locker);
+    if (stopping) {
+      return;
+    }
+    pending++;
+  }
+  this->depth(queue, 1);
+  {
+    std::lock_guard<std::mutex> lock(workers[index]->locker);
+    workers[index]->tasks.push_back(Task{queue, std::move(run)});
+  }
+  changed.notify_one();
+}
+
+// take pops the newest task of the own deque, the oldest task of another deque otherwise
+bool Executor::take(size_t index, Task &task) {
+  {
+    Worker &own = *workers[index];
+    std::lock_guard<std::mutex> lock(own.locker);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+  for (size_t i = 1; i < workers.size(); i++) {
+    Worker &victim = *workers[(index + i) % workers.size()];
+    std::lock_guard<std::mutex> lock(victim.locker);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void Executor::loop(size_t index) {
+  current_executor = this;
+  current_worker = index;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(locker);
+      changed.wait(lock, [this] { return stopping || pending > 0; });
+      if (stopping) {
+        return;
+      }
+    }
+    Task task;
+    if (!this->take(index, task)) {
+      continue; // another worker was faster
+    }
+    {
+      std::lock_guard<std::mutex> lock(locker);
+      pending--;
+    }
+    this->depth(task.queue, -1);
+    task.run();
+  }
+}
+
+namespace {
+
+// run_fan_out runs the jobs not claimed yet, the jobs taken by the others are left to them
+void run_fan_out(const std::shared_ptr<FanOut> &state) {
+  while (true) {
+    size_t index;
+    {
+      std::lock_guard<std::mutex> lock(state->locker);
+      if (state->next >= state->count) {
+        return;
+      }
+      index = state->next++;
+    }
+    int code = state->job(index);
+    {
+      std::lock_guard<std::mutex> lock(state->locker);
+      if (code != 0 && state->code == 0) {
+        state->code = code;
+      }
+      if (--state->left == 0) {
+        state->finished.notify_all();
+      }
+    }
+  }
+}
+
+} // namespace
+
+int Executor::fan_out(const std::string &queue, size_t count, const std::function<int(size_t)> &job) {
+  if (count == 0) {
+    return EXIT_SUCCESS;
+  }
+  auto state = std::make_shared<FanOut>(); // a task dropped or left behind by the shutdown still owns it
+  state->count = count;
+  state->left = count;
+  state->job = job;
+  // each task runs the jobs until none is left, the caller is one of them, so a worker more is of no use
+  size_t tasks = std::min(count - 1, workers.size());
+  for (size_t i = 0; i < tasks; i++) {
+    this->submit(queue, [state]() { run_fan_out(state); });
+  }
+  run_fan_out(state);
+  std::unique_lock<std::mutex> lock(state->locker);
+  state->finished.wait(lock, [&state] { return state->left == 0; });
+  return state->code;
+}
+
+void Executor::stop() {
+  {
+    std::lock_guard<std::mutex> lock(locker);
+    if (stopping) {
+      return;
+    }
+    stopping = true;
+  }
+  changed.notify_all();
+  for (auto &thread : threads) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  for (auto &worker : workers) {
+    std::lock_guard<std::mutex> lock(worker->locker);
+    for (const Task &task : worker->tasks) {
+      this->depth(task.queue, -1);
+    }
+    worker->tasks.clear();
+  }
+}
@@ -0,0 +1,170 @@
+#include <fair_share.h>
+
+namespace {
+
+const double SHARE_SMOOTHING = 0.02; // weight of the latest grant in the moving share
+
+} // namespace
+
+FairShare::FairShare(int64_t slots, std::map<std::string, ShareConfig> shares)
+    : slots(std::max<int64_t>(slots, 1)), shares(std::move(shares)),
+      waiting_gauge(Metrics::gauge("spider_fair_share_waiting", "Requests waiting for a slot of the fair share")) {}
+
+FairShare::Category &FairShare::get(const std::string &name) {
+  auto it = categories.find(name);
+  if (it != categories.end()) {
+    return it->second;
+  }
+  Category &category = categories[name];
+  auto share = shares.find(name);
+  if (share != shares.end()) {
+    category.config = share->second;
+  }
+  if (category.config.weight <= 0) {
+    category.config.weight = 1;
+  }
+  prometheus::Labels labels{{"type", name}};
+  category.requests = &Metrics::counter("spider_fair_share_requests_total", "Requests granted to the crawl type", labels);
+  category.hour_gauge = &Metrics::gauge("spider_fair_share_hour_requests", "Requests of the crawl type in the last hour", labels);
+  category.share_gauge = &Metrics::gauge("spider_fair_share_ratio", "Moving share of the requests granted to the crawl type", labels);
+  if (category.config.max_per_hour > 0) {
+    Metrics::gauge("spider_fair_share_hour_cap", "Requests of the crawl type allowed in an hour", labels).Set(static_cast<double>(category.config.max_per_hour));
+  }
+  return category;
+}
+
+bool FairShare::capped(Category &category, std::chrono::steady_clock::time_point now) {
+  while (!category.hour.empty() && now - category.hour.front() >= std::chrono::hours(1)) {
+    category.hour.pop_front();
+  }
+  category.hour_gauge->Set(static_cast<double>(category.hour.size()));
+  return category.config.max_per_hour > 0 && static_cast<int64_t>(category.hour.size()) >= category.config.max_per_hour;
+}
+
+const FairShare::Waiter *FairShare::next(std::chrono::steady_clock::time_point now) {
+  const Waiter *fair = nullptr;
+  const Waiter *starved = nullptr;
+  double deficit = 0;
+  for (const Waiter &waiter : waiters) {
+    Category &category = this->get(waiter.category);
+    if (this->capped(category, now)) {
+      continue;
+    }
+    double below = category.config.min - category.share;
+    if (below > deficit) {
+      deficit = below;
+      starved = &waiter;
+    }
+    if (fair == nullptr || waiter.start < fair->start) {
+      fair = &waiter;
+    }
+  }
+  return starved != nullptr ? starved : fair;
+}
+
+bool FairShare::acquire(const std::string &name) {
+  std::unique_lock<std::mutex> lock(locker);
+  Category &category = this->get(name);
+  double start = std::max(vtime, category.finish);
+  category.finish = start + 1 / category.config.weight;
+  uint64_t ticket = tickets++;
+  auto self = waiters.insert(waiters.end(), Waiter{name, start, ticket});
+  waiting_gauge.Set(static_cast<double>(waiters.size()));
+
+  while (!stopping) {
+    auto now = std::chrono::steady_clock::now();
+    const Waiter *chosen = in_use < slots ? this->next(now) : nullptr;
+    if (chosen != nullptr && chosen->ticket == ticket) {
+      in_use++;
+      vtime = std::max(vtime, start);
+      for (auto &[other, c] : categories) {
+        c.share = c.share * (1 - SHARE_SMOOTHING) + (other == name ? SHARE_SMOOTHING : 0);
+        c.share_gauge->Set(c.share);
+      }
+      category.hour.push_back(now);
+      category.hour_gauge->Set(static_cast<double>(category.hour.size()));
+      category.requests->Increment();
+      waiters.erase(self);
+      waiting_gauge.Set(static_cast<double>(waiters.size()));
+      lock.unlock();
+      changed.notify_all(); // the next waiter may take another free slot
+      return true;
+    }
+    changed.wait_for(lock, std::chrono::seconds(1)); // the hourly caps free up with the time
+  }
+  waiters.erase(self);
+  waiting_gauge.Set(static_cast<double>(waiters.size()));
+  return false;
+}
+
+void FairShare::release() {
+  {
+    std::lock_guard<std::mutex> lock(locker);
+    in_use = std::max<int64_t>(in_use - 1, 0);
+  }
+  changed.notify_all();
+}
+
+void FairShare::stop() {
+  {
+    std::lock_guard<std::mutex> lock(locker);
+    stopping = true;
+  }
+  changed.notify_all();
+}
+
+double FairShare::share(const std::string &name) {
+  std::lock_guard<std::mutex> lock(locker);
+  return this->get(name).share;
+}
+
+size_t FairShare::waiting() {
+  std::lock_guard<std::mutex> lock(locker);
+  return waiters.size();
+}
+
+bool FairShare::known(const std::string &name) {
+  for (int type = request_type_followers; type <= request_type_events; type++) {
+    if (category(static_cast<enum request_type>(type)) == name) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string FairShare::category(enum request_type type) {
+  switch (type) {
+  case request_type_followers:
+    return "followers";
+  case request_type_following:
+    return "following";
+  case request_type_user:
+    return PROFILES_QUEUE;
+  case request_type_orgs:
+    return "orgs";
+  case request_type_orgs_member:
+    return "orgs_member";
+  case request_type_users_repos:
+    return "users_repos";
+  case request_type_users_repos_branches:
+    return "users_repos_branches";
+  case request_type_users_repos_branches_commits:
+    return "users_repos_branches_commits";
+  case request_type_orgs_repos:
+    return "orgs_repos";
+  case request_type_emoji:
+    return "emojis";
+  case request_type_gitignore_list:
+  case request_type_gitignore_info:
+    return "gitignore";
+  case request_type_license_list:
+  case request_type_license_info:
+    return "license";
+  case request_type_search_users:
+  case request_type_search_repos:
+    return "search";
+  case request_type_events:
+    return "events";
+  }
+  return "unknown";
+}
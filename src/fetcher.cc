@@ -0,0 +1,213 @@
+#include <fetcher.h>
+
+Fetcher::Fetcher(size_t max_in_flight, int64_t max_host_connections, int64_t idle_timeout, int64_t timeout, const prometheus::Labels &labels)
+    : max_in_flight(max_in_flight),
+      max_host_connections(max_host_connections),
+      idle_timeout(idle_timeout),
+      timeout(timeout),
+      created_counter(Metrics::counter("spider_http_connections_total", "HTTP connections used by the transfers", {{"state", "created"}})),
+      reused_counter(Metrics::counter("spider_http_connections_total", "HTTP connections used by the transfers", {{"state", "reused"}})),
+      in_flight_gauge(Metrics::gauge("spider_http_in_flight", "HTTP transfers in flight", labels)),
+      wire_bytes_counter(Metrics::counter("spider_http_body_bytes_total", "HTTP response body bytes", {{"stage", "wire"}})),
+      decoded_bytes_counter(Metrics::counter("spider_http_body_bytes_total", "HTTP response body bytes", {{"stage", "decoded"}})) {
+  static std::once_flag curl_initialized;
+  std::call_once(curl_initialized, [] { curl_global_init(CURL_GLOBAL_DEFAULT); });
+
+  if (this->max_in_flight == 0) {
+    this->max_in_flight = 1;
+  }
+
+  multi = curl_multi_init();
+  curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+  curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(max_host_connections));
+
+  // all of the easy handles are driven by the loop thread, so the share needs no lock callbacks
+  share = curl_share_init();
+  curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+  curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+
+  loop_thread = std::thread([this] { this->loop(); });
+}
+
+Fetcher::~Fetcher() {
+  {
+    // under the lock of submit, a request is either refused or queued before the loop fails the queue
+    std::lock_guard<std::mutex> lock(locker);
+    stopping = true;
+  }
+  curl_multi_wakeup(multi);
+  if (loop_thread.joinable()) {
+    loop_thread.join();
+  }
+  curl_multi_cleanup(multi);
+  curl_share_cleanup(share);
+}
+
+void Fetcher::submit(FetchRequest request, FetchCallback callback) {
+  auto *transfer = new Transfer{};
+  transfer->request = std::move(request);
+  transfer->callback = std::move(callback);
+  {
+    std::lock_guard<std::mutex> lock(locker);
+    if (!stopping) {
+      pending.push_back(transfer);
+      transfer = nullptr;
+    }
+  }
+  if (transfer != nullptr) { // the fetcher is stopping, fail the transfer immediately
+    transfer->response.error = "fetcher is stopping";
+    transfer->callback(std::move(transfer->response));
+    delete transfer;
+    return;
+  }
+  curl_multi_wakeup(multi);
+}
+
+std::future<FetchResponse> Fetcher::submit(FetchRequest request) {
+  auto promise = std::make_shared<std::promise<FetchResponse>>();
+  std::future<FetchResponse> future = promise->get_future();
+  this->submit(std::move(request), [promise](FetchResponse response) {
+    promise->set_value(std::move(response));
+  });
+  return future;
+}
+
+size_t Fetcher::on_body(char *ptr, size_t size, size_t nmemb, void *userdata) {
+  auto *transfer = static_cast<Transfer *>(userdata);
+  transfer->response.body.append(ptr, size * nmemb);
+  return size * nmemb;
+}
+
+size_t Fetcher::on_header(char *ptr, size_t size, size_t nmemb, void *userdata) {
+  auto *transfer = static_cast<Transfer *>(userdata);
+  std::string line(ptr, size * nmemb);
+  if (line.rfind("HTTP/", 0) == 0) { // a new response begins, such as after 100 continue
+    transfer->response.headers.clear();
+    return size * nmemb;
+  }
+  size_t pos = line.find(':');
+  if (pos != std::string::npos) {
+    std::string key = boost::algorithm::trim_copy(line.substr(0, pos));
+    std::string value = boost::algorithm::trim_copy(line.substr(pos + 1));
+    transfer->response.headers.insert(std::make_pair(key, value));
+  }
+  return size * nmemb;
+}
+
+void Fetcher::start(Transfer *transfer) {
+  CURL *easy = curl_easy_init();
+  transfer->easy = easy;
+
+  for (const auto &header : transfer->request.headers) {
+    transfer->headers = curl_slist_append(transfer->headers, (header.first + ": " + header.second).c_str());
+  }
+
+  curl_easy_setopt(easy, CURLOPT_URL, transfer->request.url.c_str());
+  curl_easy_setopt(easy, CURLOPT_HTTPHEADER, transfer->headers);
+  curl_easy_setopt(easy, CURLOPT_ACCEPT_ENCODING, "gzip, deflate"); // a corrupt or truncated body fails the transfer
+  curl_easy_setopt(easy, CURLOPT_SHARE, share);
+  curl_easy_setopt(easy, CURLOPT_PRIVATE, transfer);
+  curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(easy, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+  curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);
+  curl_easy_setopt(easy, CURLOPT_MAXAGE_CONN, static_cast<long>(idle_timeout));
+  curl_easy_setopt(easy, CURLOPT_TIMEOUT_MS, static_cast<long>(transfer->request.timeout > 0 ? transfer->request.timeout : timeout));
+  curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, on_body);
+  curl_easy_setopt(easy, CURLOPT_WRITEDATA, transfer);
+  curl_easy_setopt(easy, CURLOPT_HEADERFUNCTION, on_header);
+  curl_easy_setopt(easy, CURLOPT_HEADERDATA, transfer);
+  if (transfer->request.method == "POST") {
+    curl_easy_setopt(easy, CURLOPT_POSTFIELDS, transfer->request.body.c_str());
+    curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE, static_cast<long>(transfer->request.body.size()));
+  } else if (transfer->request.method != "GET") {
+    curl_easy_setopt(easy, CURLOPT_CUSTOMREQUEST, transfer->request.method.c_str());
+  }
+
+  curl_multi_add_handle(multi, easy);
+  running.insert(transfer);
+  in_flight_gauge.Set(static_cast<double>(running.size()));
+}
+
+void Fetcher::finish(CURL *easy, CURLcode code) {
+  Transfer *transfer = nullptr;
+  curl_easy_getinfo(easy, CURLINFO_PRIVATE, reinterpret_cast<char **>(&transfer));
+
+  if (code == CURLE_OK) {
+    long status = 0;
+    curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &status);
+    transfer->response.status = static_cast<int>(status);
+    long connects = 0;
+    curl_easy_getinfo(easy, CURLINFO_NUM_CONNECTS, &connects);
+    transfer->response.reused = connects == 0;
+    if (transfer->response.reused) {
+      reused_counter.Increment();
+    } else {
+      created_counter.Increment();
+    }
+  } else {
+    transfer->response.status = 0;
+    if (transfer->response.error.empty()) {
+      transfer->response.error = curl_easy_strerror(code);
+    }
+  }
+  curl_off_t wire_bytes = 0; // the body as received, before the decoding
+  curl_easy_getinfo(easy, CURLINFO_SIZE_DOWNLOAD_T, &wire_bytes);
+  wire_bytes_counter.Increment(static_cast<double>(wire_bytes));
+  decoded_bytes_counter.Increment(static_cast<double>(transfer->response.body.size()));
+
+  curl_multi_remove_handle(multi, easy);
+  curl_easy_cleanup(easy);
+  curl_slist_free_all(transfer->headers);
+  running.erase(transfer);
+  in_flight_gauge.Set(static_cast<double>(running.size()));
+
+  transfer->callback(std::move(transfer->response));
+  delete transfer;
+}
+
+void Fetcher::loop() {
+  while (!stopping) {
+    {
+      std::lock_guard<std::mutex> lock(locker);
+      while (!pending.empty() && running.size() < max_in_flight) {
+        this->start(pending.front());
+        pending.pop_front();
+      }
+    }
+
+    int still_running = 0;
+    CURLMcode code = curl_multi_perform(multi, &still_running);
+    if (code != CURLM_OK) {
+      spdlog::error("Fetcher perform with error: {}", curl_multi_strerror(code));
+    }
+
+    int left = 0;
+    CURLMsg *message = nullptr;
+    while ((message = curl_multi_info_read(multi, &left)) != nullptr) {
+      if (message->msg == CURLMSG_DONE) {
+        this->finish(message->easy_handle, message->data.result);
+      }
+    }
+
+    curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+  }
+
+  // fail the transfers that are still running or waiting
+  std::deque<Transfer *> left;
+  {
+    std::lock_guard<std::mutex> lock(locker);
+    left.swap(pending);
+  }
+  for (Transfer *transfer : left) {
+    transfer->response.error = "fetcher is stopping";
+    transfer->callback(std::move(transfer->response));
+    delete transfer;
+  }
+  size_t count = running.size();
+  while (!running.empty()) {
+    this->finish((*running.begin())->easy, CURLE_ABORTED_BY_CALLBACK);
+  }
+  if (count > 0) {
+    spdlog::info("Fetcher aborted {} running transfers", count);
+  }
+}
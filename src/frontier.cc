@@ -0,0 +1,390 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include <zlib.h>
+
+#include <frontier.h>
+
+namespace {
+const uint32_t FRONTIER_MAGIC = 0x52465053; // SPFR
+const uint32_t FRONTIER_VERSION = 3;        // 2 added the depth to the records, 3 the score
+const uint32_t FRONTIER_DEPTH_VERSION = 2;
+const uint32_t FRONTIER_LEGACY_VERSION = 1;
+const size_t FRONTIER_MIN_CAPACITY = 1 << 20;
+const size_t FRONTIER_MAX_KEY = 4096;
+
+typedef struct FrontierLegacyRecord {
+  uint32_t size;
+  uint32_t crc; // crc32 of the key
+} FrontierLegacyRecord;
+
+typedef struct FrontierDepthRecord {
+  uint32_t size;
+  uint32_t crc; // crc32 of the depth and the key
+  uint32_t depth;
+} FrontierDepthRecord;
+
+uint32_t checksum(uint32_t depth, const char *key, size_t size) {
+  uLong crc = crc32(0, reinterpret_cast<const Bytef *>(&depth), sizeof(depth));
+  return static_cast<uint32_t>(crc32(crc, reinterpret_cast<const Bytef *>(key), static_cast<uInt>(size)));
+}
+
+uint32_t checksum(uint32_t depth, float score, const char *key, size_t size) {
+  uLong crc = crc32(0, reinterpret_cast<const Bytef *>(&depth), sizeof(depth));
+  crc = crc32(crc, reinterpret_cast<const Bytef *>(&score), sizeof(score));
+  return static_cast<uint32_t>(crc32(crc, reinterpret_cast<const Bytef *>(key), static_cast<uInt>(size)));
+}
+} // namespace
+
+Frontier::Frontier(const std::string &dir, const std::string &name, size_t max, int64_t window)
+    : name(name), path(dir + "/" + name + ".frontier"), max(max), window(window),
+      size_gauge(Metrics::gauge("spider_frontier_size", "Entity keys waiting in the frontier", {{"queue", name}})),
+      pushed_counter(Metrics::counter("spider_frontier_pushed_total", "Entity keys appended to the frontier", {{"queue", name}})) {}
+
+Frontier::~Frontier() {
+  if (data != nullptr) {
+    msync(data, capacity, MS_SYNC);
+    munmap(data, capacity);
+  }
+  if (fd >= 0) {
+    ::close(fd);
+  }
+}
+
+FrontierHeader *Frontier::header() {
+  return reinterpret_cast<FrontierHeader *>(data);
+}
+
+// map grows the file to size and maps it again, the unused part of the file reads as zeros
+int Frontier::map(size_t size) {
+  if (data != nullptr) {
+    msync(data, capacity, MS_SYNC);
+    munmap(data, capacity);
+    data = nullptr;
+  }
+  if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    spdlog::error("Resize frontier {} with error: {}", path, strerror(errno));
+    return FRONTIER_ERROR;
+  }
+  void *mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mapped == MAP_FAILED) {
+    spdlog::error("Map frontier {} with error: {}", path, strerror(errno));
+    return FRONTIER_ERROR;
+  }
+  data = static_cast<char *>(mapped);
+  capacity = size;
+  return EXIT_SUCCESS;
+}
+
+int Frontier::open() {
+  std::lock_guard<std::mutex> lock(locker);
+  std::error_code ec;
+  std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+  fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd < 0) {
+    spdlog::error("Open frontier {} with error: {}", path, strerror(errno));
+    return FRONTIER_ERROR;
+  }
+  struct stat st {};
+  if (fstat(fd, &st) != 0) {
+    spdlog::error("Stat frontier {} with error: {}", path, strerror(errno));
+    return FRONTIER_ERROR;
+  }
+  size_t size = static_cast<size_t>(st.st_size);
+  bool fresh = size < sizeof(FrontierHeader);
+  FrontierHeader old{};
+  if (!fresh && ::pread(fd, &old, sizeof(old), 0) == sizeof(old) && old.magic == FRONTIER_MAGIC && old.version == FRONTIER_DEPTH_VERSION) {
+    if (int code = this->upgrade(); code != EXIT_SUCCESS) {
+      return code;
+    }
+    if (fstat(fd, &st) != 0) {
+      spdlog::error("Stat frontier {} with error: {}", path, strerror(errno));
+      return FRONTIER_ERROR;
+    }
+    size = static_cast<size_t>(st.st_size);
+  }
+  if (fresh || size < FRONTIER_MIN_CAPACITY) {
+    size = FRONTIER_MIN_CAPACITY;
+  }
+  if (int code = this->map(size); code != EXIT_SUCCESS) {
+    return code;
+  }
+  if (fresh) {
+    *header() = FrontierHeader{FRONTIER_MAGIC, FRONTIER_VERSION, sizeof(FrontierHeader)};
+  }
+  if (header()->magic != FRONTIER_MAGIC || header()->version != FRONTIER_VERSION ||
+      header()->head < sizeof(FrontierHeader) || header()->head > capacity) {
+    spdlog::error("Frontier {} is not a frontier of this version", path);
+    return FRONTIER_ERROR;
+  }
+
+  // the records after the committed head are pending, the scan stops at the end or at a torn record
+  head = header()->head;
+  tail = head;
+  while (tail + sizeof(FrontierRecord) <= capacity) {
+    FrontierRecord record;
+    std::memcpy(&record, data + tail, sizeof(FrontierRecord));
+    uint64_t end = tail + sizeof(FrontierRecord) + record.size;
+    if (record.size == 0 || record.size > FRONTIER_MAX_KEY || end > capacity ||
+        checksum(record.depth, record.score, data + tail + sizeof(FrontierRecord), record.size) != record.crc) {
+      break;
+    }
+    pending.emplace(data + tail + sizeof(FrontierRecord), record.size);
+    tail = end;
+  }
+  std::memset(data + tail, 0, capacity - tail); // drop the torn record, the next push must not run into it
+  size_gauge.Set(static_cast<double>(pending.size()));
+  spdlog::info("Frontier {} reloaded with {} keys", name, pending.size());
+  return EXIT_SUCCESS;
+}
+
+int Frontier::legacy(const std::string &path, std::vector<std::string> &keys) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    spdlog::error("Open frontier {} with error: {}", path, strerror(errno));
+    return FRONTIER_ERROR;
+  }
+  std::string log((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  FrontierHeader old{};
+  if (log.size() >= sizeof(FrontierHeader)) {
+    std::memcpy(&old, log.data(), sizeof(FrontierHeader));
+  }
+  if (old.magic != FRONTIER_MAGIC || old.version != FRONTIER_LEGACY_VERSION || old.head < sizeof(FrontierHeader) || old.head > log.size()) {
+    spdlog::error("Frontier {} is not a frontier of version {}", path, FRONTIER_LEGACY_VERSION);
+    return FRONTIER_ERROR;
+  }
+
+  uint64_t offset = old.head;
+  while (offset + sizeof(FrontierLegacyRecord) <= log.size()) {
+    FrontierLegacyRecord record;
+    std::memcpy(&record, log.data() + offset, sizeof(FrontierLegacyRecord));
+    uint64_t end = offset + sizeof(FrontierLegacyRecord) + record.size;
+    const char *key = log.data() + offset + sizeof(FrontierLegacyRecord);
+    if (record.size == 0 || record.size > FRONTIER_MAX_KEY || end > log.size() ||
+        static_cast<uint32_t>(crc32(0, reinterpret_cast<const Bytef *>(key), record.size)) != record.crc) {
+      break;
+    }
+    keys.emplace_back(key, record.size);
+    offset = end;
+  }
+  return EXIT_SUCCESS;
+}
+
+bool Frontier::push(const std::string &key, int64_t depth, double score) {
+  if (key.empty() || key.size() > FRONTIER_MAX_KEY) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(locker);
+  if (data == nullptr || pending.size() >= max || pending.contains(key) || this->recent(key, std::time(nullptr))) {
+    return false;
+  }
+  size_t need = tail + sizeof(FrontierRecord) + key.size();
+  if (need > capacity) {
+    size_t size = capacity * 2;
+    while (size < need) {
+      size *= 2;
+    }
+    if (this->map(size) != EXIT_SUCCESS) {
+      return false;
+    }
+  }
+  auto hops = static_cast<uint32_t>(std::clamp<int64_t>(depth, 0, UINT32_MAX));
+  auto priority = static_cast<float>(score);
+  FrontierRecord record{static_cast<uint32_t>(key.size()), checksum(hops, priority, key.data(), key.size()), hops, priority};
+  std::memcpy(data + tail + sizeof(FrontierRecord), key.data(), key.size());
+  std::memcpy(data + tail, &record, sizeof(FrontierRecord)); // the size is written last, a reader stops before a half record
+  tail = need;
+  pending.insert(key);
+  pushed_counter.Increment();
+  size_gauge.Set(static_cast<double>(pending.size()));
+  return true;
+}
+
+std::vector<FrontierEntry> Frontier::pop(size_t count) {
+  std::lock_guard<std::mutex> lock(locker);
+  int64_t now = std::time(nullptr);
+  std::vector<FrontierEntry> entries;
+  while (entries.size() < count && head < tail) {
+    FrontierRecord record;
+    std::memcpy(&record, data + head, sizeof(FrontierRecord));
+    std::string key(data + head + sizeof(FrontierRecord), record.size);
+    head += sizeof(FrontierRecord) + record.size;
+    if (pending.erase(key) == 0) { // removed, or a record of a key removed and pushed again
+      continue;
+    }
+    if (window > 0) {
+      visited[key] = now;
+      pops.emplace_back(now, key);
+    }
+    entries.push_back(FrontierEntry{.key = std::move(key), .depth = record.depth, .score = record.score});
+  }
+  // the visits expire after the window, the oldest go first if there are more of them than the pending keys
+  while (!pops.empty() && (pops.front().first <= now - window || visited.size() > max)) {
+    auto it = visited.find(pops.front().second);
+    if (it != visited.end() && it->second == pops.front().first) {
+      visited.erase(it);
+    }
+    pops.pop_front();
+  }
+  size_gauge.Set(static_cast<double>(pending.size()));
+  return entries;
+}
+
+bool Frontier::requeue(const std::string &key, int64_t depth, double score) {
+  {
+    std::lock_guard<std::mutex> lock(locker);
+    visited.erase(key);
+  }
+  return this->push(key, depth, score);
+}
+
+bool Frontier::remove(const std::string &key) {
+  std::lock_guard<std::mutex> lock(locker);
+  if (pending.erase(key) == 0) {
+    return false;
+  }
+  size_gauge.Set(static_cast<double>(pending.size()));
+  return true;
+}
+
+int Frontier::commit() {
+  std::lock_guard<std::mutex> lock(locker);
+  if (data == nullptr) {
+    return FRONTIER_ERROR;
+  }
+  if (msync(data, capacity, MS_SYNC) != 0) { // the records first, the head must not point past them
+    spdlog::error("Sync frontier {} with error: {}", path, strerror(errno));
+    return FRONTIER_ERROR;
+  }
+  header()->head = head;
+  if (msync(data, sizeof(FrontierHeader), MS_SYNC) != 0) {
+    spdlog::error("Sync frontier {} with error: {}", path, strerror(errno));
+    return FRONTIER_ERROR;
+  }
+  if (head - sizeof(FrontierHeader) > capacity / 2 && capacity > FRONTIER_MIN_CAPACITY) {
+    return this->compact();
+  }
+  return EXIT_SUCCESS;
+}
+
+// compact writes the pending records to a new log and renames it over the old one, a crash leaves
+// either of them complete
+int Frontier::compact() {
+  std::string temp = path + ".tmp";
+  int out = ::open(temp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (out < 0) {
+    spdlog::error("Open frontier {} with error: {}", temp, strerror(errno));
+    return FRONTIER_ERROR;
+  }
+  FrontierHeader fresh{FRONTIER_MAGIC, FRONTIER_VERSION, sizeof(FrontierHeader)};
+  size_t size = std::max(FRONTIER_MIN_CAPACITY, static_cast<size_t>(tail - head + sizeof(FrontierHeader)) * 2);
+  bool ok = ::write(out, &fresh, sizeof(fresh)) == sizeof(fresh) &&
+            ::write(out, data + head, tail - head) == static_cast<ssize_t>(tail - head) &&
+            ftruncate(out, static_cast<off_t>(size)) == 0 && fsync(out) == 0;
+  ::close(out);
+  if (!ok || std::rename(temp.c_str(), path.c_str()) != 0) {
+    spdlog::error("Compact frontier {} with error: {}", path, strerror(errno));
+    std::remove(temp.c_str());
+    return FRONTIER_ERROR;
+  }
+
+  munmap(data, capacity);
+  data = nullptr;
+  ::close(fd);
+  fd = ::open(path.c_str(), O_RDWR);
+  if (fd < 0) {
+    spdlog::error("Open frontier {} with error: {}", path, strerror(errno));
+    return FRONTIER_ERROR;
+  }
+  tail = tail - head + sizeof(FrontierHeader);
+  head = sizeof(FrontierHeader);
+  return this->map(size);
+}
+
+// upgrade rewrites the pending records of a log of version 2 with a score of 0, the same way as compact
+int Frontier::upgrade() {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    spdlog::error("Open frontier {} with error: {}", path, strerror(errno));
+    return FRONTIER_ERROR;
+  }
+  std::string log((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  FrontierHeader old{};
+  std::memcpy(&old, log.data(), sizeof(FrontierHeader));
+  if (old.head < sizeof(FrontierHeader) || old.head > log.size()) {
+    spdlog::error("Frontier {} is not a frontier of version {}", path, FRONTIER_DEPTH_VERSION);
+    return FRONTIER_ERROR;
+  }
+
+  std::string records;
+  size_t count = 0;
+  uint64_t offset = old.head;
+  while (offset + sizeof(FrontierDepthRecord) <= log.size()) {
+    FrontierDepthRecord record;
+    std::memcpy(&record, log.data() + offset, sizeof(FrontierDepthRecord));
+    uint64_t end = offset + sizeof(FrontierDepthRecord) + record.size;
+    const char *key = log.data() + offset + sizeof(FrontierDepthRecord);
+    if (record.size == 0 || record.size > FRONTIER_MAX_KEY || end > log.size() || checksum(record.depth, key, record.size) != record.crc) {
+      break;
+    }
+    FrontierRecord upgraded{record.size, checksum(record.depth, 0.0F, key, record.size), record.depth, 0.0F};
+    records.append(reinterpret_cast<const char *>(&upgraded), sizeof(upgraded));
+    records.append(key, record.size);
+    count++;
+    offset = end;
+  }
+
+  std::string temp = path + ".tmp";
+  int out = ::open(temp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (out < 0) {
+    spdlog::error("Open frontier {} with error: {}", temp, strerror(errno));
+    return FRONTIER_ERROR;
+  }
+  FrontierHeader fresh{FRONTIER_MAGIC, FRONTIER_VERSION, sizeof(FrontierHeader)};
+  size_t size = std::max(FRONTIER_MIN_CAPACITY, (records.size() + sizeof(FrontierHeader)) * 2);
+  bool ok = ::write(out, &fresh, sizeof(fresh)) == sizeof(fresh) &&
+            ::write(out, records.data(), records.size()) == static_cast<ssize_t>(records.size()) &&
+            ftruncate(out, static_cast<off_t>(size)) == 0 && fsync(out) == 0;
+  ::close(out);
+  if (!ok || std::rename(temp.c_str(), path.c_str()) != 0) {
+    spdlog::error("Upgrade frontier {} with error: {}", path, strerror(errno));
+    std::remove(temp.c_str());
+    return FRONTIER_ERROR;
+  }
+
+  ::close(fd);
+  fd = ::open(path.c_str(), O_RDWR);
+  if (fd < 0) {
+    spdlog::error("Open frontier {} with error: {}", path, strerror(errno));
+    return FRONTIER_ERROR;
+  }
+  spdlog::info("Frontier {} upgraded to version {} with {} keys", name, FRONTIER_VERSION, count);
+  return EXIT_SUCCESS;
+}
+
+bool Frontier::contains(const std::string &key) {
+  std::lock_guard<std::mutex> lock(locker);
+  return pending.contains(key);
+}
+
+bool Frontier::recent(const std::string &key, int64_t now) {
+  auto it = visited.find(key);
+  return it != visited.end() && it->second > now - window;
+}
+
+bool Frontier::seen(const std::string &key) {
+  std::lock_guard<std::mutex> lock(locker);
+  return pending.contains(key) || this->recent(key, std::time(nullptr));
+}
+
+size_t Frontier::size() {
+  std::lock_guard<std::mutex> lock(locker);
+  return pending.size();
+}
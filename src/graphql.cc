@@ -0,0 +1,96 @@
+#include <graphql.h>
+
+namespace {
+
+// the fields of User, the counters are the ones of the REST profile
+const std::string GRAPHQL_USER_FRAGMENT = R"(fragment user on User {
+  login databaseId id name company websiteUrl location email isHireable bio createdAt updatedAt
+  gists(privacy: PUBLIC) { totalCount }
+  repositories(privacy: PUBLIC, ownerAffiliations: OWNER) { totalCount }
+  following { totalCount }
+  followers { totalCount }
+})";
+
+std::string text(const nlohmann::json &node, const std::string &key) {
+  auto it = node.find(key);
+  return it != node.end() && it->is_string() ? it->get<std::string>() : "";
+}
+
+bool flag(const nlohmann::json &node, const std::string &key) {
+  auto it = node.find(key);
+  return it != node.end() && it->is_boolean() && it->get<bool>();
+}
+
+int64_t total_count(const nlohmann::json &node, const std::string &key) {
+  auto it = node.find(key);
+  if (it == node.end() || !it->is_object()) {
+    return 0;
+  }
+  auto count = it->find("totalCount");
+  return count != it->end() && count->is_number_integer() ? count->get<int64_t>() : 0;
+}
+
+} // namespace
+
+std::string graphql_users_query(const std::vector<std::string> &logins) {
+  std::string query = "query {";
+  for (size_t i = 0; i < logins.size(); i++) {
+    query += fmt::format(" u{}: user(login: {}) {{ ...user }}", i, nlohmann::json(logins[i]).dump());
+  }
+  return query + " }\n" + GRAPHQL_USER_FRAGMENT;
+}
+
+int graphql_users_parse(const std::string &body, const std::vector<std::string> &logins, std::vector<User> &users, std::vector<std::string> &missing) {
+  nlohmann::json content;
+  try {
+    content = nlohmann::json::parse(body);
+  } catch (const std::exception &e) {
+    spdlog::error("Parse graphql users with error: {}", e.what());
+    return JSON_PARSE_ERROR;
+  }
+  if (!content.is_object()) {
+    return REQUEST_ERROR;
+  }
+  auto errors = content.find("errors");
+  if (errors != content.end() && errors->is_array()) {
+    for (const nlohmann::json &error : *errors) {
+      if (error.is_object() && text(error, "type") == GRAPHQL_RATE_LIMITED) {
+        return RATE_LIMITED_ERROR;
+      }
+    }
+  }
+  auto data = content.find("data");
+  if (data == content.end() || !data->is_object()) {
+    spdlog::error("Graphql users got error: {}", content.value("errors", nlohmann::json::array()).dump());
+    return REQUEST_ERROR;
+  }
+
+  for (size_t i = 0; i < logins.size(); i++) {
+    auto node = data->find(fmt::format("u{}", i));
+    if (node == data->end() || !node->is_object() || !(*node)["databaseId"].is_number_integer()) {
+      missing.push_back(logins[i]);
+      continue;
+    }
+    User user{
+        .id = (*node)["databaseId"].get<int64_t>(),
+        .login = text(*node, "login"),
+        .node_id = text(*node, "id"),
+        .type = "User",
+        .name = text(*node, "name"),
+        .company = text(*node, "company"),
+        .blog = text(*node, "websiteUrl"),
+        .location = text(*node, "location"),
+        .email = text(*node, "email"),
+        .hireable = flag(*node, "isHireable"),
+        .bio = text(*node, "bio"),
+        .created_at = text(*node, "createdAt"),
+        .updated_at = text(*node, "updatedAt"),
+        .public_gists = total_count(*node, "gists"),
+        .public_repos = total_count(*node, "repositories"),
+        .following = total_count(*node, "following"),
+        .followers = total_count(*node, "followers"),
+    };
+    users.push_back(user);
+  }
+  return EXIT_SUCCESS;
+}
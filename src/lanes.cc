@@ -0,0 +1,28 @@
+#include <lanes.h>
+
+Lanes::Lanes(TokenScheduler *tokens, Lane shared, std::vector<Lane> lanes) : tokens(tokens), shared(shared), lanes(std::move(lanes)) {}
+
+Lanes::~Lanes() {
+  for (Lane &lane : lanes) {
+    delete lane.fetcher;
+    delete lane.pacer;
+  }
+}
+
+bool Lanes::split() {
+  return !lanes.empty();
+}
+
+Lane Lanes::lane(int token) {
+  if (token < 0 || static_cast<size_t>(token) >= lanes.size()) {
+    return shared;
+  }
+  return lanes[token];
+}
+
+int64_t Lanes::reserve(int token) {
+  if (token < 0 || lanes.empty()) {
+    return shared.pacer->reserve(tokens->rate());
+  }
+  return this->lane(token).pacer->reserve(tokens->rate(token));
+}
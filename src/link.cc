@@ -0,0 +1,121 @@
+#include <link.h>
+
+static std::string_view trim(std::string_view value) {
+  while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+    value.remove_prefix(1);
+  }
+  while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+    value.remove_suffix(1);
+  }
+  return value;
+}
+
+static void assign(LinkHeader &link, std::string_view rel, std::string_view url) {
+  if (rel == "next") {
+    link.next = url;
+  } else if (rel == "last") {
+    link.last = url;
+  } else if (rel == "prev") {
+    link.prev = url;
+  } else if (rel == "first") {
+    link.first = url;
+  }
+}
+
+LinkHeader parse_link(std::string_view header) {
+  LinkHeader link;
+  size_t pos = 0;
+  while (pos < header.size()) {
+    size_t begin = header.find('<', pos);
+    if (begin == std::string_view::npos) {
+      break;
+    }
+    size_t end = header.find('>', begin + 1);
+    if (end == std::string_view::npos) {
+      break;
+    }
+    std::string_view url = header.substr(begin + 1, end - begin - 1);
+
+    // the parameters run until the next link value
+    size_t stop = header.find(',', end + 1);
+    if (stop == std::string_view::npos) {
+      stop = header.size();
+    }
+    std::string_view params = header.substr(end + 1, stop - end - 1);
+    pos = stop + 1;
+
+    while (!params.empty()) {
+      size_t semicolon = params.find(';');
+      std::string_view param = trim(params.substr(0, semicolon));
+      params = semicolon == std::string_view::npos ? std::string_view{} : params.substr(semicolon + 1);
+
+      if (param.size() < 4 || param.substr(0, 3) != "rel") {
+        continue;
+      }
+      param = trim(param.substr(3));
+      if (param.empty() || param.front() != '=') {
+        continue;
+      }
+      param = trim(param.substr(1));
+      if (param.size() >= 2 && param.front() == '"' && param.back() == '"') {
+        param = param.substr(1, param.size() - 2);
+      }
+      // rel may hold several space separated relations
+      while (!param.empty()) {
+        size_t space = param.find(' ');
+        assign(link, param.substr(0, space), url);
+        param = space == std::string_view::npos ? std::string_view{} : trim(param.substr(space + 1));
+      }
+    }
+  }
+  return link;
+}
+
+void split_url(std::string_view url, std::string_view &origin, std::string_view &path) {
+  size_t scheme = url.find("://");
+  size_t start = scheme == std::string_view::npos ? 0 : scheme + 3;
+  size_t slash = url.find('/', start);
+  if (slash == std::string_view::npos) {
+    origin = url;
+    path = "/";
+    return;
+  }
+  origin = url.substr(0, slash);
+  path = url.substr(slash);
+}
+
+// page_param returns the position of the page parameter value, npos if there is none
+static size_t page_param(std::string_view url) {
+  size_t query = url.find('?');
+  while (query != std::string_view::npos) {
+    if (url.substr(query + 1, 5) == "page=") {
+      return query + 6;
+    }
+    query = url.find('&', query + 1);
+  }
+  return std::string_view::npos;
+}
+
+int64_t link_page(std::string_view url) {
+  size_t pos = page_param(url);
+  if (pos == std::string_view::npos) {
+    return 0;
+  }
+  int64_t page = 0;
+  for (; pos < url.size() && url[pos] >= '0' && url[pos] <= '9'; pos++) {
+    page = page * 10 + (url[pos] - '0');
+  }
+  return page;
+}
+
+std::string link_with_page(std::string_view url, int64_t page) {
+  size_t pos = page_param(url);
+  if (pos == std::string_view::npos) {
+    return std::string(url) + (url.find('?') == std::string_view::npos ? "?" : "&") + "page=" + std::to_string(page);
+  }
+  size_t end = pos;
+  while (end < url.size() && url[end] >= '0' && url[end] <= '9') {
+    end++;
+  }
+  return std::string(url.substr(0, pos)) + std::to_string(page) + std::string(url.substr(end));
+}
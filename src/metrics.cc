@@ -0,0 +1,30 @@
+#include <metrics.h>
+
+std::mutex Metrics::locker;
+std::map<std::string, prometheus::Family<prometheus::Counter> *> Metrics::counters;
+std::map<std::string, prometheus::Family<prometheus::Gauge> *> Metrics::gauges;
+
+std::shared_ptr<prometheus::Registry> Metrics::registry() {
+  static std::shared_ptr<prometheus::Registry> registry = std::make_shared<prometheus::Registry>();
+  return registry;
+}
+
+prometheus::Counter &Metrics::counter(const std::string &name, const std::string &help, const prometheus::Labels &labels) {
+  std::lock_guard<std::mutex> lock(locker);
+  auto it = counters.find(name);
+  if (it == counters.end()) {
+    auto &family = prometheus::BuildCounter().Name(name).Help(help).Register(*registry());
+    it = counters.insert(std::make_pair(name, &family)).first;
+  }
+  return it->second->Add(labels);
+}
+
+prometheus::Gauge &Metrics::gauge(const std::string &name, const std::string &help, const prometheus::Labels &labels) {
+  std::lock_guard<std::mutex> lock(locker);
+  auto it = gauges.find(name);
+  if (it == gauges.end()) {
+    auto &family = prometheus::BuildGauge().Name(name).Help(help).Register(*registry());
+    it = gauges.insert(std::make_pair(name, &family)).first;
+  }
+  return it->second->Add(labels);
+}
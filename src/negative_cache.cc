@@ -0,0 +1,110 @@
+#include <negative_cache.h>
+
+NegativeCache::NegativeCache()
+    : hits_counter(Metrics::counter("spider_negative_hits_total", "Requests skipped because the entity is dead")),
+      size_gauge(Metrics::gauge("spider_negative_cache_size", "Dead entities kept in memory")) {}
+
+int64_t NegativeCache::now() {
+  return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string NegativeCache::entry_key(const std::string &collection, const std::string &key) {
+  return collection + ":" + key;
+}
+
+bool NegativeCache::dead(const std::string &collection, const std::string &key) {
+  std::lock_guard<std::mutex> lock(locker);
+  auto it = entries.find(entry_key(collection, key));
+  if (it == entries.end()) {
+    return false;
+  }
+  if (it->second.expire_at <= now()) {
+    entries.erase(it);
+    size_gauge.Set(static_cast<double>(entries.size()));
+    return false;
+  }
+  hits_counter.Increment();
+  return true;
+}
+
+bool NegativeCache::keep(const Negative &negative) {
+  std::lock_guard<std::mutex> lock(locker);
+  if (negative.expire_at <= now()) {
+    return false;
+  }
+  entries[entry_key(negative.collection, negative.key)] = negative;
+  size_gauge.Set(static_cast<double>(entries.size()));
+  return true;
+}
+
+void NegativeCache::put(const Negative &negative) {
+  if (this->keep(negative)) {
+    Metrics::counter("spider_negative_entries_total", "Entities found dead", {{"status", std::to_string(negative.status)}}).Increment();
+  }
+}
+
+void NegativeCache::load(const Negative &negative) {
+  this->keep(negative);
+}
+
+bool NegativeCache::entity(const std::string &path, std::string &collection, std::string &key) {
+  std::string_view rest = path;
+  std::string_view query;
+  size_t mark = rest.find('?');
+  if (mark != std::string_view::npos) {
+    query = rest.substr(mark + 1);
+    rest = rest.substr(0, mark);
+  }
+
+  auto segment = [&rest]() {
+    if (!rest.empty() && rest.front() == '/') {
+      rest.remove_prefix(1);
+    }
+    size_t end = rest.find('/');
+    std::string_view s = rest.substr(0, end);
+    rest.remove_prefix(end == std::string_view::npos ? rest.size() : end);
+    return s;
+  };
+
+  // owned is true for the entity itself and for its lists, the query of a list only pages through it
+  auto owned = [&rest, &query, &segment]() {
+    std::string_view list = segment();
+    if (!rest.empty() && rest != "/") {
+      return false;
+    }
+    if (list.empty()) {
+      return true;
+    }
+    while (!query.empty()) {
+      size_t end = query.find('&');
+      std::string_view param = query.substr(0, end);
+      query.remove_prefix(end == std::string_view::npos ? query.size() : end + 1);
+      std::string_view name = param.substr(0, param.find('='));
+      if (name != "per_page" && name != "page") {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  std::string_view first = segment();
+  if (first == "users" || first == "orgs") {
+    std::string_view name = segment();
+    if (!name.empty()) {
+      collection = first;
+      key = name;
+      return owned();
+    }
+  } else if (first == "repos") {
+    std::string_view owner = segment();
+    std::string_view repo = segment();
+    if (!owner.empty() && !repo.empty()) {
+      collection = "repos";
+      key = std::string(owner) + "/" + std::string(repo);
+      return owned();
+    }
+  }
+  collection = "";
+  key = path;
+  return true;
+}
@@ -0,0 +1,48 @@
+#include <pacer.h>
+
+namespace {
+
+const double MAX_FACTOR = 64;
+const double FACTOR_STEP = 0.1; // additive shrink after each good request
+const double SPIKE = 3;         // a latency this many times the average is a spike
+const int64_t SPIKE_FLOOR = 1000;
+
+} // namespace
+
+Pacer::Pacer(int64_t max_interval, const prometheus::Labels &labels)
+    : max_interval(max_interval),
+      next(std::chrono::steady_clock::now()),
+      interval_gauge(Metrics::gauge("spider_pacer_interval_milliseconds", "Interval between two requests", labels)),
+      factor_gauge(Metrics::gauge("spider_pacer_factor", "Stretch of the interval by errors and latency", labels)) {
+  factor_gauge.Set(factor);
+}
+
+int64_t Pacer::reserve(double rate) {
+  thread_local std::mt19937 generator{std::random_device{}()};
+  std::uniform_real_distribution<double> jitter{0.9, 1.1};
+
+  std::lock_guard<std::mutex> lock(locker);
+  // the jitter goes before the bound, so max_interval is the ceiling of an interval not stretched by the factor
+  double interval = rate > 0 ? std::min(1000 / rate * jitter(generator), static_cast<double>(max_interval)) : static_cast<double>(max_interval);
+  interval *= factor;
+  interval_gauge.Set(interval);
+
+  auto now = std::chrono::steady_clock::now();
+  auto slot = std::max(now, next);
+  next = slot + std::chrono::microseconds(static_cast<int64_t>(interval * 1000));
+  return std::chrono::duration_cast<std::chrono::milliseconds>(slot - now).count();
+}
+
+void Pacer::observe(bool failed, int64_t latency_ms) {
+  std::lock_guard<std::mutex> lock(locker);
+  bool spike = latency > 0 && latency_ms > SPIKE_FLOOR && static_cast<double>(latency_ms) > latency * SPIKE;
+  if (failed) {
+    factor = std::min(factor * 2, MAX_FACTOR);
+  } else if (spike) {
+    factor = std::min(factor * 1.5, MAX_FACTOR);
+  } else {
+    factor = std::max(factor - FACTOR_STEP, 1.0);
+  }
+  latency = latency == 0 ? static_cast<double>(latency_ms) : latency * 0.8 + static_cast<double>(latency_ms) * 0.2;
+  factor_gauge.Set(factor);
+}
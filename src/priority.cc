@@ -0,0 +1,135 @@
+#include <priority.h>
+
+double Priority::user(const User &user, int64_t depth) {
+  return std::log10(1.0 + static_cast<double>(std::max<int64_t>(user.followers, 0))) +
+         0.5 * std::log10(1.0 + static_cast<double>(std::max<int64_t>(user.public_repos, 0))) -
+         PRIORITY_DEPTH_PENALTY * static_cast<double>(depth);
+}
+
+double Priority::repo(const Repo &repo, int64_t depth) {
+  return std::log10(1.0 + static_cast<double>(std::max<int64_t>(repo.stargazers_count, 0))) +
+         0.5 * std::log10(1.0 + static_cast<double>(std::max<int64_t>(repo.forks_count, 0))) -
+         PRIORITY_DEPTH_PENALTY * static_cast<double>(depth);
+}
+
+double Priority::inherit(double score) {
+  return score - PRIORITY_DEPTH_PENALTY;
+}
+
+int Priority::band(double score) {
+  if (!(score > 0)) { // NaN too
+    return 0;
+  }
+  return static_cast<int>(std::min<double>(std::floor(score), PRIORITY_BANDS - 1));
+}
+
+PriorityFrontier::PriorityFrontier(const std::string &dir, const std::string &name, size_t max, int64_t window)
+    : legacy(dir + "/" + name + ".frontier"),
+      promoted_counter(Metrics::counter("spider_frontier_promoted_total", "Entity keys moved up to a higher band", {{"queue", name}})) {
+  for (int band = 0; band < PRIORITY_BANDS; band++) {
+    bands.emplace_back(std::make_unique<Frontier>(dir, fmt::format("{}.{}", name, band), max, window));
+  }
+}
+
+int PriorityFrontier::open() {
+  for (auto &frontier : bands) {
+    WRAP_FUNC(frontier->open())
+  }
+  if (!std::filesystem::exists(legacy)) {
+    return EXIT_SUCCESS;
+  }
+  // the keys of the log without bands have no score nor depth, they wait in the lowest band
+  std::vector<std::string> keys;
+  WRAP_FUNC(Frontier::legacy(legacy, keys))
+  size_t migrated = 0;
+  for (const std::string &key : keys) {
+    migrated += this->push(key, 0, PRIORITY_SAMPLED_DEPTH) ? 1 : 0;
+  }
+  WRAP_FUNC(bands[0]->commit())
+  std::filesystem::remove(legacy);
+  spdlog::info("Frontier {} migrated {} of {} keys to band 0", legacy, migrated, keys.size());
+  return EXIT_SUCCESS;
+}
+
+bool PriorityFrontier::push(const std::string &key, double score, int64_t depth) {
+  std::lock_guard<std::mutex> lock(locker);
+  auto target = static_cast<size_t>(Priority::band(score));
+  for (size_t band = 0; band < bands.size(); band++) {
+    if (!bands[band]->seen(key)) {
+      continue;
+    }
+    if (band >= target || !bands[band]->remove(key)) {
+      return false;
+    }
+    if (!bands[target]->push(key, depth, score)) { // the higher band is full, the key keeps its place
+      bands[band]->push(key, depth, score);
+      return false;
+    }
+    promoted_counter.Increment();
+    return true;
+  }
+  return bands[target]->push(key, depth, score);
+}
+
+std::vector<FrontierEntry> PriorityFrontier::pop(size_t count) {
+  std::vector<size_t> sizes(bands.size());
+  size_t weights = 0;
+  for (size_t band = 0; band < bands.size(); band++) {
+    sizes[band] = bands[band]->size();
+    if (sizes[band] > 0) {
+      weights += size_t(1) << band;
+    }
+  }
+  std::vector<FrontierEntry> entries;
+  if (weights == 0) {
+    return entries;
+  }
+  // the weighted shares first, the rest of the batch is filled from the highest band down
+  for (int pass = 0; pass < 2 && entries.size() < count; pass++) {
+    for (size_t band = bands.size(); band-- > 0 && entries.size() < count;) {
+      if (sizes[band] == 0) {
+        continue;
+      }
+      size_t want = count - entries.size();
+      if (pass == 0) {
+        want = std::min(want, std::max<size_t>(1, count * (size_t(1) << band) / weights));
+      }
+      for (FrontierEntry &entry : bands[band]->pop(want)) {
+        entry.band = static_cast<int>(band);
+        if (Priority::band(entry.score) != entry.band) { // upgraded from a log without the scores
+          entry.score = static_cast<double>(band);
+        }
+        entries.push_back(std::move(entry));
+      }
+    }
+  }
+  return entries;
+}
+
+void PriorityFrontier::requeue(const std::vector<FrontierEntry> &entries) {
+  std::lock_guard<std::mutex> lock(locker);
+  for (const FrontierEntry &entry : entries) {
+    if (entry.band >= 0 && static_cast<size_t>(entry.band) < bands.size()) {
+      bands[entry.band]->requeue(entry.key, entry.depth, entry.score);
+    }
+  }
+}
+
+int PriorityFrontier::commit() {
+  int code = EXIT_SUCCESS;
+  for (auto &frontier : bands) {
+    int err = frontier->commit();
+    if (err != EXIT_SUCCESS) {
+      code = err;
+    }
+  }
+  return code;
+}
+
+size_t PriorityFrontier::size() {
+  size_t total = 0;
+  for (auto &frontier : bands) {
+    total += frontier->size();
+  }
+  return total;
+}
@@ -0,0 +1,170 @@
+#include <retry.h>
+
+namespace {
+
+const double MAX_BUDGET = 100;
+
+// GitHub asks to wait at least a minute after a secondary rate limit without Retry-After
+const int64_t SECONDARY_BASE_DELAY = 60000;
+const int64_t SECONDARY_MAX_DELAY = 15 * 60000;
+
+} // namespace
+
+RetryPolicy::RetryPolicy(int64_t max_attempts, double budget_ratio, int64_t breaker_failures, int64_t breaker_cooldown, int64_t base_delay,
+                         int64_t max_delay)
+    : max_attempts(max_attempts),
+      budget_ratio(budget_ratio),
+      breaker_failures(breaker_failures),
+      breaker_cooldown(breaker_cooldown),
+      backoffs({
+          {retry_secondary, {SECONDARY_BASE_DELAY, SECONDARY_MAX_DELAY}},
+          {retry_server, {base_delay, max_delay}},
+          {retry_transport, {std::max<int64_t>(base_delay / 2, 1), std::max<int64_t>(max_delay / 2, 1)}},
+      }),
+      budget(MAX_BUDGET / 10),
+      budget_gauge(Metrics::gauge("spider_retry_budget", "Retries left in the retry budget")) {
+  budget_gauge.Set(budget);
+}
+
+int64_t RetryPolicy::now() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+const char *RetryPolicy::name(enum retry_class retry) {
+  switch (retry) {
+  case retry_primary:
+    return "primary";
+  case retry_secondary:
+    return "secondary";
+  case retry_server:
+    return "server";
+  case retry_transport:
+    return "transport";
+  default:
+    return "none";
+  }
+}
+
+bool RetryPolicy::allow(const std::string &endpoint) {
+  std::lock_guard<std::mutex> lock(locker);
+  auto it = breakers.find(endpoint);
+  if (it == breakers.end() || it->second.open_until == 0) {
+    return true;
+  }
+  Breaker &breaker = it->second;
+  if (now() >= breaker.open_until && !breaker.probing) { // half open, one request probes the endpoint
+    breaker.probing = true;
+    return true;
+  }
+  Metrics::counter("spider_circuit_rejected_total", "Requests rejected by an open circuit breaker", {{"endpoint", endpoint}}).Increment();
+  return false;
+}
+
+void RetryPolicy::record(const std::string &endpoint, enum retry_class retry) {
+  std::lock_guard<std::mutex> lock(locker);
+  budget = std::min(MAX_BUDGET, budget + budget_ratio);
+  budget_gauge.Set(budget);
+
+  Breaker &breaker = breakers[endpoint];
+  if (retry != retry_server && retry != retry_transport) {
+    if (breaker.open_until != 0) {
+      spdlog::info("Circuit of {} is closed", endpoint);
+      Metrics::gauge("spider_circuit_open", "Circuit breaker of the endpoint is open", {{"endpoint", endpoint}}).Set(0);
+    }
+    breaker = Breaker{};
+    return;
+  }
+  breaker.failures++;
+  if (breaker.probing || breaker.failures >= breaker_failures) {
+    breaker.open_until = now() + breaker_cooldown;
+    breaker.probing = false;
+    spdlog::error("Circuit of {} is open for {}ms after {} failures", endpoint, breaker_cooldown, breaker.failures);
+    Metrics::counter("spider_circuit_opened_total", "Circuit breakers opened", {{"endpoint", endpoint}}).Increment();
+    Metrics::gauge("spider_circuit_open", "Circuit breaker of the endpoint is open", {{"endpoint", endpoint}}).Set(1);
+  }
+}
+
+int64_t RetryPolicy::backoff(enum retry_class retry, int64_t attempt, const Headers &headers) {
+  auto it = backoffs.find(retry);
+  if (it == backoffs.end()) {
+    return -1;
+  }
+  if (attempt >= max_attempts) {
+    Metrics::counter("spider_retry_exhausted_total", "Requests given up by the retry policy", {{"reason", "attempts"}}).Increment();
+    return -1;
+  }
+  {
+    std::lock_guard<std::mutex> lock(locker);
+    if (budget < 1) {
+      Metrics::counter("spider_retry_exhausted_total", "Requests given up by the retry policy", {{"reason", "budget"}}).Increment();
+      return -1;
+    }
+    budget -= 1;
+    budget_gauge.Set(budget);
+  }
+
+  thread_local std::mt19937_64 generator{std::random_device{}()};
+  int64_t delay;
+  auto retry_after = headers.find("Retry-After");
+  if (retry_after != headers.end() && !retry_after->second.empty() && std::all_of(retry_after->second.begin(), retry_after->second.end(), ::isdigit)) {
+    // Retry-After is the earliest time, a little jitter keeps the waiting threads from coming back at once
+    delay = std::stoll(retry_after->second) * 1000 + std::uniform_int_distribution<int64_t>{0, 1000}(generator);
+    Metrics::counter("spider_retry_after_total", "Retries delayed by Retry-After").Increment();
+  } else {
+    int64_t ceiling = std::min(it->second.cap, it->second.base << std::min<int64_t>(attempt, 20));
+    delay = retry == retry_secondary ? it->second.base + std::uniform_int_distribution<int64_t>{0, ceiling}(generator)
+                                     : std::uniform_int_distribution<int64_t>{0, ceiling}(generator);
+  }
+
+  Metrics::counter("spider_retry_total", "Requests retried", {{"class", name(retry)}}).Increment();
+  Metrics::counter("spider_retry_backoff_seconds_total", "Seconds waited before the retries", {{"class", name(retry)}}).Increment(static_cast<double>(delay) / 1000);
+  return delay;
+}
+
+enum retry_class RetryPolicy::classify(int status, const Headers &headers, const std::string &body) {
+  if (status == 0) {
+    return retry_transport;
+  }
+  if (status == 500 || status == 502 || status == 503 || status == 504) {
+    return retry_server;
+  }
+  if (status == 403 || status == 429) {
+    auto it = headers.find("X-RateLimit-Remaining");
+    if (it != headers.end() && it->second == "0") {
+      return retry_primary;
+    }
+    if (headers.find("Retry-After") != headers.end() || body.find("secondary rate limit") != std::string::npos ||
+        body.find("abuse detection") != std::string::npos) {
+      return retry_secondary;
+    }
+  }
+  return retry_none;
+}
+
+std::string RetryPolicy::endpoint(const std::string &path) {
+  std::string_view rest = path;
+  size_t query = rest.find('?');
+  if (query != std::string_view::npos) {
+    rest = rest.substr(0, query);
+  }
+  std::vector<std::string_view> segments;
+  while (!rest.empty()) {
+    if (rest.front() == '/') {
+      rest.remove_prefix(1);
+      continue;
+    }
+    size_t end = std::min(rest.find('/'), rest.size());
+    segments.push_back(rest.substr(0, end));
+    rest.remove_prefix(end);
+  }
+
+  // the resource names sit at the even positions, the ids between them, /repos has two ids
+  std::string result;
+  bool repos = !segments.empty() && segments[0] == "repos";
+  for (size_t i = 0; i < segments.size(); i++) {
+    bool id = i > 0 && (repos ? (i <= 2 || i % 2 == 0) : i % 2 == 1);
+    result += "/";
+    result += id ? std::string_view(":id") : segments[i];
+  }
+  return result.empty() ? "/" : result;
+}
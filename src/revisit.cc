@@ -0,0 +1,59 @@
+#include <revisit.h>
+
+int64_t revisit_time(const std::string &time) {
+  int year = 0;
+  unsigned month = 0, day = 0, hour = 0, minute = 0, second = 0;
+  if (sscanf(time.c_str(), "%d-%u-%uT%u:%u:%u", &year, &month, &day, &hour, &minute, &second) != 6) {
+    return 0;
+  }
+  std::chrono::year_month_day date{std::chrono::year{year}, std::chrono::month{month}, std::chrono::day{day}};
+  if (!date.ok() || hour > 23 || minute > 59 || second > 60) {
+    return 0;
+  }
+  auto days = std::chrono::sys_days{date}.time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::seconds>(days).count() + hour * 3600 + minute * 60 + second;
+}
+
+double revisit_rate(const Revisit &revisit, int64_t now) {
+  double rate = 0;
+  if (revisit.visits > 0 && revisit.observed > 0) {
+    double interval = revisit.observed / revisit.visits;
+    rate = -std::log((revisit.visits - revisit.changes + 0.5) / (revisit.visits + 0.5)) / interval;
+  }
+  int64_t changed = revisit_time(revisit.last_change);
+  if (rate <= 0 && changed > 0 && now > changed) { // no change seen yet, it is about as old as the last change
+    rate = 1.0 / static_cast<double>(now - changed);
+  }
+  return rate;
+}
+
+int64_t revisit_interval(double rate, int64_t min, int64_t max) {
+  if (rate <= 0) {
+    return max;
+  }
+  double interval = -std::log(1 - REVISIT_TARGET) / rate;
+  if (interval >= static_cast<double>(max)) {
+    return max;
+  }
+  return std::max(min, static_cast<int64_t>(interval));
+}
+
+void revisit_observe(Revisit &revisit, const std::string &changed_at, int64_t now, int64_t min, int64_t max) {
+  if (revisit.visited_at > 0 && now > revisit.visited_at) {
+    if (revisit.visits >= REVISIT_HISTORY) {
+      double fade = (REVISIT_HISTORY - 1) / revisit.visits;
+      revisit.visits *= fade;
+      revisit.changes *= fade;
+      revisit.observed *= fade;
+    }
+    revisit.visits++;
+    revisit.changes += !changed_at.empty() && changed_at != revisit.last_change ? 1 : 0;
+    revisit.observed += static_cast<double>(now - revisit.visited_at);
+  }
+  if (!changed_at.empty()) {
+    revisit.last_change = changed_at;
+  }
+  revisit.visited_at = now;
+  revisit.rate = revisit_rate(revisit, now);
+  revisit.next_at = now + revisit_interval(revisit.rate, min, max);
+}
@@ -0,0 +1,57 @@
+#include <search.h>
+
+SearchRange search_all(const std::string &kind, int64_t today) {
+  return SearchRange{
+      .kind = kind,
+      .from = search_day(SEARCH_FIRST_DAY),
+      .to = today,
+  };
+}
+
+std::string search_query(const SearchRange &range) {
+  std::string count = fmt::format("{}..{}", range.low, range.high < 0 ? "*" : std::to_string(range.high));
+  std::string created = fmt::format("created:{}..{}", search_day(range.from), search_day(range.to));
+  if (range.kind == SEARCH_USERS) {
+    return fmt::format("type:user+{}+followers:{}", created, count);
+  }
+  return fmt::format("{}+stars:{}", created, count);
+}
+
+bool split_search(const SearchRange &range, SearchRange &first, SearchRange &second) {
+  first = range;
+  second = range;
+  if (range.from < range.to) {
+    int64_t middle = range.from + (range.to - range.from) / 2;
+    first.to = middle;
+    second.from = middle + 1;
+    return true;
+  }
+  if (range.high < 0) { // most of the users and repos have few followers or stars, the unbounded end is cut first
+    int64_t middle = range.low * 2 + 10;
+    first.high = middle;
+    second.low = middle + 1;
+    return true;
+  }
+  if (range.low < range.high) {
+    int64_t middle = range.low + (range.high - range.low) / 2;
+    first.high = middle;
+    second.low = middle + 1;
+    return true;
+  }
+  return false;
+}
+
+std::string search_day(int64_t days) {
+  std::chrono::year_month_day date{std::chrono::sys_days{std::chrono::days{days}}};
+  return fmt::format("{:04}-{:02}-{:02}", static_cast<int>(date.year()), static_cast<unsigned>(date.month()), static_cast<unsigned>(date.day()));
+}
+
+int64_t search_day(const std::string &day) {
+  int year = 0;
+  unsigned month = 0, date = 0;
+  if (sscanf(day.c_str(), "%d-%u-%u", &year, &month, &date) != 3) {
+    return 0;
+  }
+  std::chrono::sys_days days{std::chrono::year{year} / std::chrono::month{month} / std::chrono::day{date}};
+  return days.time_since_epoch().count();
+}
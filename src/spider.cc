@@ -8,6 +8,7 @@
 #include <config.h>
 #include <const.h>
 
+#include <application/prome.h>
 #include <application/request.h>
 #include <application/server.h>
 #include <database/mongo.h>
@@ -92,12 +93,21 @@ int main(int argc, char const *argv[]) {
     keep_running = false;
   }
 
+  Application *prome = new Prome(config, database);
+
+  code = prome->startup();
+  if (code != 0) {
+    spdlog::error("Prometheus exporter startup got error: {}", code);
+    keep_running = false;
+  }
+
   while (keep_running) {
     std::this_thread::sleep_for(std::chrono::milliseconds(200)); // run loop
   }
 
   delete request;
   delete server;
+  delete prome;
   delete database;
 
   spdlog::info("All of applications stopped...");
@@ -0,0 +1,259 @@
+#include <zlib.h>
+
+#include <tokens.h>
+
+TokenScheduler::TokenScheduler(std::vector<std::string> tokens, int64_t reserve)
+    : tokens(std::move(tokens)), reserve(reserve) {
+  budgets.resize(this->tokens.size());
+}
+
+void TokenScheduler::share(BudgetReserver budget_reserver, int64_t budget_chunk) {
+  std::lock_guard<std::mutex> lock(locker);
+  reserver = std::move(budget_reserver);
+  chunk = budget_chunk;
+}
+
+std::string TokenScheduler::id(int index) {
+  const std::string &token = tokens[index];
+  uLong crc = crc32(0L, reinterpret_cast<const Bytef *>(token.data()), static_cast<uInt>(token.size()));
+  return fmt::format("{:08x}", crc);
+}
+
+int64_t TokenScheduler::now() {
+  return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// kept is the reserve of the budget, at most a tenth of the limit, the search limit is 30 a minute only
+int64_t TokenScheduler::kept(const TokenBudget &budget) {
+  return std::min(reserve, budget.limit / 10);
+}
+
+int64_t TokenScheduler::available(TokenBudget &budget, int64_t current) {
+  if (budget.paused_until > current) {
+    return 0;
+  }
+  if (budget.known && budget.reset <= current) { // the window is over, GitHub will report the new budget
+    budget.remaining = budget.limit;
+    budget.known = false;
+  }
+  int64_t left = budget.remaining - budget.in_flight - this->kept(budget);
+  return left > 0 ? left : 0;
+}
+
+// window is the reset of a known budget, the replicas agree on it as GitHub reports the same reset to all of them
+int64_t TokenScheduler::window(TokenBudget &budget) {
+  return budget.reset;
+}
+
+// reserve_chunk asks the shared budget for a chunk of the token without the lock, returns false if nothing was granted
+bool TokenScheduler::reserve_chunk(std::unique_lock<std::mutex> &lock, int index, const std::string &resource) {
+  TokenBudget &budget = budgets[index][resource];
+  int64_t reserving_window = this->window(budget);
+  int64_t cap = std::max<int64_t>(budget.limit - this->kept(budget), 0);
+  budget.reserving = true;
+  lock.unlock();
+  int64_t got = reserver(index, resource, reserving_window, cap, chunk);
+  lock.lock();
+  budget.reserving = false;
+  if (got >= 0 && budget.window == reserving_window) {
+    budget.granted += got;
+    budget.exhausted = got == 0;
+    Metrics::counter("spider_token_shared_reserved_total", "Requests of the shared budget reserved by this replica", {{"token", std::to_string(index)}, {"resource", resource}})
+        .Increment(static_cast<double>(got));
+  }
+  changed.notify_all();
+  return got > 0;
+}
+
+void TokenScheduler::observe(int index, const std::string &resource, const TokenBudget &budget) {
+  Metrics::gauge("spider_token_remaining", "Rate limit budget left of the token", {{"token", std::to_string(index)}, {"resource", resource}})
+      .Set(static_cast<double>(budget.remaining));
+}
+
+int TokenScheduler::acquire(const std::string &resource) {
+  std::unique_lock<std::mutex> lock(locker);
+  while (!stopping) {
+    int64_t current = now();
+    int best = -1;
+    int64_t best_available = 0;
+    int64_t wake = 0; // the nearest time a drained token gets budget back
+    int starved = -1; // a token with budget left but none of the shared budget reserved
+    for (size_t i = 0; i < budgets.size(); i++) {
+      TokenBudget &budget = budgets[i][resource];
+      int64_t left = this->available(budget, current);
+      int64_t back = std::max(budget.reset, budget.paused_until);
+      bool drained = left == 0;
+      if (reserver && !budget.known) { // no window the replicas agree on yet, a single request probes the budget
+        left = budget.in_flight > 0 ? 0 : std::min<int64_t>(left, 1);
+      } else if (reserver) {
+        int64_t current_window = this->window(budget);
+        if (budget.window != current_window) { // the requests granted are spent or expired with the window
+          budget.window = current_window;
+          budget.granted = 0;
+          budget.exhausted = false;
+        }
+        if (left > 0 && budget.granted == 0 && !budget.exhausted && !budget.reserving && starved < 0) {
+          starved = static_cast<int>(i);
+        }
+        if (budget.exhausted) {
+          back = std::max(back, current_window);
+          drained = true;
+        }
+        left = std::min(left, budget.granted);
+      }
+      if (left > best_available) {
+        best = static_cast<int>(i);
+        best_available = left;
+      }
+      if (drained && back > current && (wake == 0 || back < wake)) {
+        wake = back;
+      }
+    }
+    if (best >= 0) {
+      TokenBudget &budget = budgets[best][resource];
+      budget.in_flight++;
+      if (reserver && budget.known) {
+        budget.granted--;
+      }
+      return best;
+    }
+    if (starved >= 0) {
+      if (!this->reserve_chunk(lock, starved, resource)) {
+        changed.wait_for(lock, std::chrono::seconds(1)); // the shared budget is spent or out of reach
+      }
+      continue;
+    }
+    if (wake == 0) { // drained by the requests in flight, wait for their answers
+      changed.wait_for(lock, std::chrono::seconds(1));
+    } else {
+      spdlog::info("All of the tokens are drained for {}, wait {}s until the budget resets", resource, wake - current);
+      changed.wait_until(lock, std::chrono::system_clock::time_point(std::chrono::seconds(wake + 1)));
+    }
+  }
+  return -1;
+}
+
+void TokenScheduler::release(int index, const std::string &resource) {
+  {
+    std::lock_guard<std::mutex> lock(locker);
+    TokenBudget &budget = budgets[index][resource];
+    budget.in_flight = std::max<int64_t>(budget.in_flight - 1, 0);
+    if (reserver && budget.known) { // the request was not counted by GitHub
+      budget.granted++;
+    }
+  }
+  changed.notify_all();
+}
+
+bool TokenScheduler::update(int index, int status, const Headers &headers, const std::string &resource) {
+  bool limited = false;
+  {
+    std::lock_guard<std::mutex> lock(locker);
+    TokenBudget &budget = budgets[index][resource];
+    budget.in_flight = std::max<int64_t>(budget.in_flight - 1, 0);
+
+    std::string reported = resource; // /rate_limit and conditional requests may be counted to another resource
+    auto it = headers.find("X-RateLimit-Resource");
+    if (it != headers.end()) {
+      reported = it->second;
+    }
+    TokenBudget &target = budgets[index][reported];
+    bool has_remaining = false;
+    try {
+      if ((it = headers.find("X-RateLimit-Limit")) != headers.end()) {
+        target.limit = std::stoll(it->second);
+      }
+      if ((it = headers.find("X-RateLimit-Remaining")) != headers.end()) {
+        target.remaining = std::stoll(it->second);
+        has_remaining = true;
+      }
+      if ((it = headers.find("X-RateLimit-Reset")) != headers.end()) {
+        target.reset = std::stoll(it->second);
+      }
+      if ((status == 403 || status == 429) && (it = headers.find("Retry-After")) != headers.end()) {
+        target.paused_until = now() + std::stoll(it->second);
+        limited = true;
+      }
+    } catch (const std::exception &e) {
+      spdlog::error("Parse rate limit headers with error: {}", e.what());
+    }
+    if (has_remaining) {
+      target.known = true;
+      this->observe(index, reported, target);
+      if (target.remaining % 100 == 0) {
+        std::time_t reset = target.reset;
+        char buffer[32];
+        std::strftime(buffer, 32, "%Y/%m/%d %H:%M:%S", std::localtime(&reset));
+        SPDLOG_INFO("Rate limit of token {} {}: {}/{}, reset at: {}", index, reported, target.remaining, target.limit, buffer);
+      }
+    }
+    if ((status == 403 || status == 429) && has_remaining && target.remaining == 0) {
+      limited = true;
+    }
+  }
+  changed.notify_all();
+  return limited;
+}
+
+void TokenScheduler::set(int index, const std::string &resource, int64_t limit, int64_t remaining, int64_t reset) {
+  {
+    std::lock_guard<std::mutex> lock(locker);
+    TokenBudget &budget = budgets[index][resource];
+    budget.limit = limit;
+    budget.remaining = remaining;
+    budget.reset = reset;
+    budget.known = true;
+    this->observe(index, resource, budget);
+  }
+  changed.notify_all();
+}
+
+void TokenScheduler::drain(int index, const std::string &resource, int64_t seconds) {
+  std::lock_guard<std::mutex> lock(locker);
+  TokenBudget &budget = budgets[index][resource];
+  int64_t current = now();
+  int64_t until = budget.known && budget.reset > current ? budget.reset : current + seconds;
+  budget.paused_until = std::max(budget.paused_until, until);
+}
+
+void TokenScheduler::stop() {
+  {
+    std::lock_guard<std::mutex> lock(locker);
+    stopping = true;
+  }
+  changed.notify_all();
+}
+
+int64_t TokenScheduler::total(const std::string &resource) {
+  std::lock_guard<std::mutex> lock(locker);
+  int64_t current = now();
+  int64_t sum = 0;
+  for (auto &budget : budgets) {
+    sum += this->available(budget[resource], current);
+  }
+  return sum;
+}
+
+double TokenScheduler::rate(TokenBudget &budget, int64_t current) {
+  int64_t left = this->available(budget, current);
+  if (left == 0) {
+    return 0;
+  }
+  int64_t window = budget.known ? std::max<int64_t>(budget.reset - current, 1) : 3600; // the window of GitHub is an hour
+  return static_cast<double>(left) / static_cast<double>(window);
+}
+
+double TokenScheduler::rate(const std::string &resource) {
+  std::lock_guard<std::mutex> lock(locker);
+  int64_t current = now();
+  double sum = 0;
+  for (auto &budget : budgets) {
+    sum += this->rate(budget[resource], current);
+  }
+  return sum;
+}
+
+double TokenScheduler::rate(int index, const std::string &resource) {
+  std::lock_guard<std::mutex> lock(locker);
+  return this->rate(budgets[index][resource], now());
+}
@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+
+#include <fmt/format.h>
+
+#include <decoder/sax.h>
+#include <decoder/simd.h>
+
+namespace {
+
+class TersePrinter : public testing::EmptyTestEventListener {
+private:
+  void OnTestProgramStart(const testing::UnitTest & /* unit_test */) override {}
+
+  void OnTestProgramEnd(const testing::UnitTest &unit_test) override {
+    fprintf(stdout, "TEST %s\n", unit_test.Passed() ? "PASSED" : "FAILED");
+    fflush(stdout);
+  }
+};
+
+const std::string user_body = R"({
+  "login": "octocat", "id": 583231, "node_id": "MDQ6VXNlcjU4MzIzMQ==",
+  "avatar_url": "https://avatars.githubusercontent.com/u/583231?v=4", "url": "https://api.github.com/users/octocat",
+  "type": "User", "site_admin": false, "name": "The Octocat", "company": "@github", "blog": "https://github.blog",
+  "location": "San Francisco", "email": null, "hireable": null, "bio": null, "twitter_username": null,
+  "public_repos": 8, "public_gists": 8, "followers": 9950, "following": 9,
+  "created_at": "2011-01-25T18:44:36Z", "updated_at": "2023-01-22T12:13:51Z"
+})";
+
+const std::string repos_body = R"([
+  {"id": 1296269, "node_id": "MDEwOlJlcG9zaXRvcnkxMjk2MjY5", "name": "Hello-World", "full_name": "octocat/Hello-World",
+   "private": false, "owner": {"login": "octocat", "id": 1, "type": "User", "url": "https://api.github.com/users/octocat"},
+   "description": "This your first repo!", "fork": false, "homepage": "https://github.com", "size": 108,
+   "stargazers_count": 80, "watchers_count": 80, "language": "C", "forks_count": 9, "open_issues": 0,
+   "topics": ["octocat", "api"], "permissions": {"admin": false, "push": false, "pull": true},
+   "license": {"key": "mit", "name": "MIT License", "url": "https://api.github.com/licenses/mit"},
+   "forks": 9, "watchers": 80, "default_branch": "master", "score": 1.5,
+   "pushed_at": "2011-01-26T19:06:43Z", "created_at": "2011-01-26T19:01:12Z", "updated_at": "2011-01-26T19:14:43Z"},
+  {"id": 2, "name": "Spoon-Knife", "private": true, "owner": {"login": "github", "type": "Organization"},
+   "description": null, "fork": true, "license": null, "language": null, "size": 18446744073709551615}
+])";
+
+template <class T>
+class decoder : public testing::Test {};
+
+using Decoders = testing::Types<SaxDecoder, SimdDecoder>;
+TYPED_TEST_SUITE(decoder, Decoders);
+
+TYPED_TEST(decoder, user) {
+  TypeParam decoder;
+  User user;
+  ASSERT_EQ(decoder.decode_user(user_body, user), SPIDER_OK);
+  EXPECT_EQ(user.login, "octocat");
+  EXPECT_EQ(user.id, 583231);
+  EXPECT_EQ(user.node_id, "MDQ6VXNlcjU4MzIzMQ==");
+  EXPECT_EQ(user.type, "User");
+  EXPECT_EQ(user.name, "The Octocat");
+  EXPECT_EQ(user.company, "@github");
+  EXPECT_EQ(user.blog, "https://github.blog");
+  EXPECT_EQ(user.location, "San Francisco");
+  EXPECT_TRUE(user.email.empty());
+  EXPECT_FALSE(user.hireable);
+  EXPECT_TRUE(user.bio.empty());
+  EXPECT_EQ(user.public_repos, 8);
+  EXPECT_EQ(user.public_gists, 8);
+  EXPECT_EQ(user.followers, 9950);
+  EXPECT_EQ(user.following, 9);
+  EXPECT_EQ(user.created_at, "2011-01-25T18:44:36Z");
+  EXPECT_EQ(user.updated_at, "2023-01-22T12:13:51Z");
+}
+
+TYPED_TEST(decoder, users) {
+  TypeParam decoder;
+  std::vector<User> users;
+  ASSERT_EQ(decoder.decode_users(R"([{"login": "a", "id": 1, "type": "User"}, {"login": "b", "id": 2, "node_id": "x", "hireable": true}])", users), SPIDER_OK);
+  ASSERT_EQ(users.size(), 2);
+  EXPECT_EQ(users[0].login, "a");
+  EXPECT_EQ(users[0].id, 1);
+  EXPECT_EQ(users[0].type, "User");
+  EXPECT_FALSE(users[0].hireable);
+  EXPECT_EQ(users[1].login, "b");
+  EXPECT_EQ(users[1].node_id, "x");
+  EXPECT_TRUE(users[1].hireable);
+
+  users.clear();
+  ASSERT_EQ(decoder.decode_users("[]", users), SPIDER_OK);
+  EXPECT_TRUE(users.empty());
+}
+
+TYPED_TEST(decoder, repos) {
+  TypeParam decoder;
+  std::vector<Repo> repos;
+  ASSERT_EQ(decoder.decode_repos(repos_body, repos), SPIDER_OK);
+  ASSERT_EQ(repos.size(), 2);
+  const Repo &repo = repos[0];
+  EXPECT_EQ(repo.id, 1296269);
+  EXPECT_EQ(repo.node_id, "MDEwOlJlcG9zaXRvcnkxMjk2MjY5");
+  EXPECT_EQ(repo.name, "Hello-World");
+  EXPECT_EQ(repo.full_name, "octocat/Hello-World");
+  EXPECT_FALSE(repo.xprivate);
+  EXPECT_EQ(repo.owner, "octocat");
+  EXPECT_EQ(repo.owner_type, "User");
+  EXPECT_EQ(repo.description, "This your first repo!");
+  EXPECT_FALSE(repo.fork);
+  EXPECT_EQ(repo.homepage, "https://github.com");
+  EXPECT_EQ(repo.size, 108);
+  EXPECT_EQ(repo.stargazers_count, 80);
+  EXPECT_EQ(repo.watchers_count, 80);
+  EXPECT_EQ(repo.forks_count, 9);
+  EXPECT_EQ(repo.language, "C");
+  EXPECT_EQ(repo.license, "mit");
+  EXPECT_EQ(repo.forks, 9);
+  EXPECT_EQ(repo.open_issues, 0);
+  EXPECT_EQ(repo.watchers, 80);
+  EXPECT_EQ(repo.default_branch, "master");
+  EXPECT_EQ(repo.pushed_at, "2011-01-26T19:06:43Z");
+  EXPECT_EQ(repo.created_at, "2011-01-26T19:01:12Z");
+  EXPECT_EQ(repo.updated_at, "2011-01-26T19:14:43Z");
+
+  EXPECT_EQ(repos[1].id, 2);
+  EXPECT_TRUE(repos[1].xprivate);
+  EXPECT_TRUE(repos[1].fork);
+  EXPECT_EQ(repos[1].owner, "github");
+  EXPECT_EQ(repos[1].owner_type, "Organization");
+  EXPECT_TRUE(repos[1].description.empty());
+  EXPECT_TRUE(repos[1].license.empty());
+  EXPECT_TRUE(repos[1].language.empty());
+  EXPECT_EQ(repos[1].stargazers_count, 0);
+}
+
+TYPED_TEST(decoder, orgs) {
+  TypeParam decoder;
+  std::vector<Org> orgs;
+  ASSERT_EQ(decoder.decode_orgs(R"([{"login": "github", "id": 1, "node_id": "MDEyOk9yZ2FuaXphdGlvbjE=", "url": "https://api.github.com/orgs/github", "description": "A great organization"}])", orgs), SPIDER_OK);
+  ASSERT_EQ(orgs.size(), 1);
+  EXPECT_EQ(orgs[0].id, 1);
+  EXPECT_EQ(orgs[0].login, "github");
+  EXPECT_EQ(orgs[0].node_id, "MDEyOk9yZ2FuaXphdGlvbjE=");
+  EXPECT_EQ(orgs[0].description, "A great organization");
+}
+
+TYPED_TEST(decoder, search) {
+  TypeParam decoder;
+  std::vector<User> users;
+  int64_t total = 0;
+  bool incomplete = true;
+  std::string users_body = R"({"total_count": 2049, "incomplete_results": false, "items": [
+    {"login": "octocat", "id": 583231, "type": "User", "score": 1.0, "text_matches": [{"fragment": "x"}]},
+    {"login": "github", "id": 9919, "type": "Organization", "score": 1.0}]})";
+  ASSERT_EQ(decoder.decode_search_users(users_body, users, total, incomplete), SPIDER_OK);
+  EXPECT_EQ(total, 2049);
+  EXPECT_FALSE(incomplete);
+  ASSERT_EQ(users.size(), 2);
+  EXPECT_EQ(users[0].login, "octocat");
+  EXPECT_EQ(users[1].id, 9919);
+  EXPECT_EQ(users[1].type, "Organization");
+
+  std::vector<Repo> repos;
+  std::string repos_page = fmt::format(R"({{"total_count": 2, "incomplete_results": true, "items": {}}})", repos_body);
+  ASSERT_EQ(decoder.decode_search_repos(repos_page, repos, total, incomplete), SPIDER_OK);
+  EXPECT_EQ(total, 2);
+  EXPECT_TRUE(incomplete);
+  ASSERT_EQ(repos.size(), 2);
+  EXPECT_EQ(repos[0].owner, "octocat");
+  EXPECT_EQ(repos[0].license, "mit");
+  EXPECT_EQ(repos[1].full_name, "");
+
+  users.clear();
+  EXPECT_EQ(decoder.decode_search_users("[]", users, total, incomplete), JSON_PARSE_ERROR);
+}
+
+TYPED_TEST(decoder, invalid) {
+  TypeParam decoder;
+  User user;
+  std::vector<User> users;
+  std::vector<Repo> repos;
+  EXPECT_EQ(decoder.decode_user("", user), JSON_PARSE_ERROR);
+  EXPECT_EQ(decoder.decode_user("[]", user), JSON_PARSE_ERROR);
+  EXPECT_EQ(decoder.decode_users(R"({"message": "Not Found"})", users), JSON_PARSE_ERROR);
+  EXPECT_EQ(decoder.decode_repos(R"([{"id": 1, "name": "x")", repos), JSON_PARSE_ERROR);
+}
+std::string dump(const User &u) {
+  return fmt::format("{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}", u.id, u.login, u.node_id, u.type, u.name, u.company, u.blog, u.location,
+                     u.email, u.hireable, u.bio, u.created_at, u.updated_at, u.public_gists, u.public_repos, u.following, u.followers);
+}
+
+std::string dump(const Repo &r) {
+  return fmt::format("{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}", r.id, r.node_id, r.name, r.full_name, r.xprivate, r.owner,
+                     r.owner_type, r.description, r.fork, r.created_at, r.updated_at, r.pushed_at, r.homepage, r.size, r.stargazers_count,
+                     r.watchers_count, r.forks_count, r.language, r.license, r.forks, r.open_issues, r.watchers, r.default_branch);
+}
+
+// the simdjson backend must give the same models as the nlohmann one
+TEST(simd_decoder, same_as_sax) {
+  SaxDecoder sax;
+  SimdDecoder simd;
+
+  User sax_user, simd_user;
+  ASSERT_EQ(sax.decode_user(user_body, sax_user), SPIDER_OK);
+  ASSERT_EQ(simd.decode_user(user_body, simd_user), SPIDER_OK);
+  EXPECT_EQ(dump(sax_user), dump(simd_user));
+
+  std::vector<Repo> sax_repos, simd_repos;
+  ASSERT_EQ(sax.decode_repos(repos_body, sax_repos), SPIDER_OK);
+  ASSERT_EQ(simd.decode_repos(repos_body, simd_repos), SPIDER_OK);
+  ASSERT_EQ(sax_repos.size(), simd_repos.size());
+  for (size_t i = 0; i < sax_repos.size(); i++) {
+    EXPECT_EQ(dump(sax_repos[i]), dump(simd_repos[i]));
+  }
+
+  std::string escaped = R"({"login": "a\"b\u00e9", "id": 1, "bio": "line\nbreak", "hireable": true})";
+  ASSERT_EQ(sax.decode_user(escaped, sax_user), SPIDER_OK);
+  ASSERT_EQ(simd.decode_user(escaped, simd_user), SPIDER_OK);
+  EXPECT_EQ(sax_user.login, "a\"b\u00e9");
+  EXPECT_EQ(dump(sax_user), dump(simd_user));
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  testing::UnitTest &unit_test = *testing::UnitTest::GetInstance();
+  testing::TestEventListeners &listeners = unit_test.listeners();
+  delete listeners.Release(listeners.default_result_printer());
+  listeners.Append(new TersePrinter);
+  return RUN_ALL_TESTS();
+}
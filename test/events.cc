@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <events.h>
+
+namespace {
+
+class TersePrinter : public testing::EmptyTestEventListener {
+private:
+  void OnTestProgramStart(const testing::UnitTest & /* unit_test */) override {}
+
+  void OnTestProgramEnd(const testing::UnitTest &unit_test) override {
+    fprintf(stdout, "TEST %s\n", unit_test.Passed() ? "PASSED" : "FAILED");
+    fflush(stdout);
+  }
+};
+
+nlohmann::json event(const std::string &id, const std::string &type, const std::string &repo, nlohmann::json payload) {
+  return nlohmann::json{
+      {"id", id},
+      {"type", type},
+      {"actor", {{"id", 1}, {"login", "tosone"}}},
+      {"repo", {{"id", 2}, {"name", repo}}},
+      {"payload", payload},
+      {"created_at", "2021-09-12T13:13:00Z"},
+  };
+}
+
+TEST(events, push) {
+  nlohmann::json events = nlohmann::json::array({event("11", "PushEvent", "spider-all/spider", {{"ref", "refs/heads/feature/x"}, {"head", "abc"}})});
+  EventActions actions = event_actions(events, 0);
+  EXPECT_EQ(actions.last, 11);
+  EXPECT_EQ(actions.count, 1);
+  ASSERT_EQ(actions.users.size(), 1);
+  EXPECT_EQ(actions.users[0].login, "tosone");
+  ASSERT_EQ(actions.repos.size(), 1);
+  EXPECT_EQ(actions.repos[0].owner, "spider-all");
+  EXPECT_EQ(actions.repos[0].name, "spider");
+  EXPECT_EQ(actions.repos[0].pushed_at, "2021-09-12T13:13:00Z");
+  EXPECT_TRUE(actions.recrawls.contains({"users_repos_branches", "spider;spider-all"}));
+  EXPECT_TRUE(actions.recrawls.contains({"users_repos_branches_commits", "spider;spider-all;feature/x"}));
+}
+
+TEST(events, after) {
+  nlohmann::json events = nlohmann::json::array({
+      event("13", "WatchEvent", "spider-all/spider", {{"action", "started"}}),
+      event("12", "WatchEvent", "spider-all/spider", {{"action", "started"}}),
+      event("11", "WatchEvent", "spider-all/spider", {{"action", "started"}}),
+  });
+  EventActions actions = event_actions(events, 11);
+  EXPECT_EQ(actions.last, 13);
+  EXPECT_EQ(actions.count, 2);
+  EXPECT_EQ(actions.users.size(), 1); // the same actor once
+  ASSERT_EQ(actions.repos.size(), 2);
+  EXPECT_EQ(actions.repos[0].stars, 1);
+  EXPECT_TRUE(actions.recrawls.empty());
+
+  actions = event_actions(events, 13);
+  EXPECT_EQ(actions.count, 0);
+  EXPECT_EQ(actions.last, 0);
+}
+
+TEST(events, owners) {
+  nlohmann::json created = event("21", "CreateEvent", "spider-all/spider", {{"ref_type", "repository"}});
+  created["org"] = {{"id", 3}, {"login", "spider-all"}};
+  nlohmann::json events = nlohmann::json::array({
+      created,
+      event("22", "PublicEvent", "tosone/spider", ""), // null turned into the empty string by the parser
+      event("23", "ForkEvent", "spider-all/spider", {{"forkee", {{"name", "spider"}, {"owner", {{"login", "fork-org"}, {"type", "Organization"}}}}}}),
+      event("24", "MemberEvent", "tosone/spider", {{"member", {{"id", 4}, {"login", "someone"}}}}),
+      event("25", "IssuesEvent", "tosone/spider", {{"action", "opened"}}),
+  });
+  EventActions actions = event_actions(events, 0);
+  EXPECT_EQ(actions.count, 5);
+  EXPECT_TRUE(actions.recrawls.contains({"orgs_repos", "spider-all"}));
+  EXPECT_TRUE(actions.recrawls.contains({"users_repos", "tosone"}));
+  EXPECT_TRUE(actions.recrawls.contains({"orgs_repos", "fork-org"}));
+  EXPECT_EQ(actions.recrawls.size(), 3);
+  ASSERT_EQ(actions.repos.size(), 1);
+  EXPECT_EQ(actions.repos[0].forks, 1);
+  ASSERT_EQ(actions.users.size(), 2);
+  EXPECT_EQ(actions.users[1].login, "someone");
+}
+
+TEST(events, malformed) {
+  nlohmann::json bot = event("33", "PushEvent", "spider-all/spider", {{"ref", "refs/tags/v1"}});
+  bot["actor"]["login"] = "dependabot[bot]";
+  nlohmann::json events = nlohmann::json::array({
+      nlohmann::json{{"type", "PushEvent"}},
+      nlohmann::json{{"id", "31"}, {"type", "PushEvent"}},
+      "junk",
+      bot,
+  });
+  EventActions actions = event_actions(events, 0);
+  EXPECT_EQ(actions.count, 2);
+  EXPECT_EQ(actions.last, 33);
+  EXPECT_TRUE(actions.users.empty());
+  EXPECT_EQ(actions.repos.size(), 1);
+  EXPECT_EQ(actions.recrawls.size(), 1); // a tag has no branch to crawl the commits of
+  EXPECT_EQ(event_actions(nlohmann::json::object(), 0).count, 0);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  testing::UnitTest &unit_test = *testing::UnitTest::GetInstance();
+  testing::TestEventListeners &listeners = unit_test.listeners();
+  delete listeners.Release(listeners.default_result_printer());
+  listeners.Append(new TersePrinter);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,158 @@
+#include <set>
+
+#include <gtest/gtest.h>
+
+#include <executor.h>
+
+namespace {
+
+class TersePrinter : public testing::EmptyTestEventListener {
+private:
+  void OnTestProgramStart(const testing::UnitTest & /* unit_test */) override {}
+
+  void OnTestProgramEnd(const testing::UnitTest &unit_test) override {
+    fprintf(stdout, "TEST %s\n", unit_test.Passed() ? "PASSED" : "FAILED");
+    fflush(stdout);
+  }
+};
+
+TEST(executor, run_all) {
+  Executor executor(4);
+  std::atomic<int> done = 0;
+  EXPECT_EQ(executor.fan_out("test", 1000, [&](size_t) {
+    done++;
+    return 0;
+  }),
+            0);
+  EXPECT_EQ(done, 1000);
+  for (int i = 0; i < 100 && executor.depth("test") > 0; i++) { // the tasks that found no job left
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(executor.depth("test"), 0);
+  EXPECT_EQ(executor.fan_out("test", 0, [&](size_t) { return 1; }), 0);
+}
+
+TEST(executor, steal) {
+  Executor executor(4);
+  std::mutex locker;
+  std::set<std::thread::id> threads;
+  std::atomic<int> done = 0;
+  executor.submit("parent", [&]() { // every child is queued on the deque of this worker
+    executor.fan_out("child", 8, [&](size_t) {
+      {
+        std::lock_guard<std::mutex> lock(locker);
+        threads.insert(std::this_thread::get_id());
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      done++;
+      return 0;
+    });
+  });
+  for (int i = 0; i < 100 && done < 8; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(done, 8);
+  EXPECT_GT(threads.size(), 1);
+}
+
+TEST(executor, nested_wait) {
+  Executor executor(1); // the only worker waits for its own subtasks, it must run them itself
+  std::atomic<int> children = 0;
+  std::atomic<bool> parent = false;
+  executor.submit("parent", [&]() {
+    executor.fan_out("child", 10, [&](size_t) {
+      children++;
+      return 0;
+    });
+    parent = true;
+  });
+  for (int i = 0; i < 100 && !parent; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_TRUE(parent);
+  EXPECT_EQ(children, 10);
+}
+
+// the caller of a fan-out runs its own jobs only, never the unrelated tasks queued next to them
+TEST(executor, own_jobs) {
+  Executor executor(1);
+  std::atomic<bool> blocked = true;
+  std::atomic<int> unrelated = 0;
+  executor.submit("busy", [&]() {
+    while (blocked) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  for (int i = 0; i < 10; i++) {
+    executor.submit("unrelated", [&]() { unrelated++; });
+  }
+  std::set<size_t> jobs;
+  int code = executor.fan_out("jobs", 5, [&](size_t i) {
+    jobs.insert(i); // the only worker is busy, the caller runs all of them
+    return i == 3 ? 7 : 0;
+  });
+  EXPECT_EQ(code, 7);
+  EXPECT_EQ(jobs.size(), 5);
+  EXPECT_EQ(unrelated, 0);
+  blocked = false;
+}
+
+// the rest pages of a list are walked by pages_in_flight jobs taking the next page each
+TEST(executor, pages) {
+  Executor executor(8);
+  const int64_t last = 40, in_flight = 4;
+  auto page = std::make_shared<std::atomic<int64_t>>(2);
+  std::mutex locker;
+  std::map<int64_t, int> fetched;
+  std::atomic<int> running = 0, most = 0;
+  int code = executor.fan_out("pages", in_flight, [&](size_t) {
+    while (true) {
+      int64_t current = (*page)++;
+      if (current > last) {
+        break;
+      }
+      int now = ++running;
+      for (int seen = most; now > seen && !most.compare_exchange_weak(seen, now);) {
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      running--;
+      std::lock_guard<std::mutex> lock(locker);
+      fetched[current]++;
+    }
+    return 0;
+  });
+  EXPECT_EQ(code, 0);
+  EXPECT_EQ(fetched.size(), last - 1);
+  for (const auto &[current, count] : fetched) {
+    EXPECT_EQ(count, 1) << "page " << current;
+  }
+  EXPECT_LE(most, in_flight);
+}
+
+TEST(executor, stop) {
+  Executor executor(2);
+  std::atomic<int> started = 0;
+  for (int i = 0; i < 100; i++) {
+    executor.submit("slow", [&]() {
+      started++;
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    });
+  }
+  executor.stop(); // the running tasks are joined, the queued ones are dropped
+  EXPECT_LT(started, 100);
+  EXPECT_EQ(executor.depth("slow"), 0);
+
+  executor.submit("slow", [&]() { started++; });
+  EXPECT_EQ(executor.depth("slow"), 0);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  testing::UnitTest &unit_test = *testing::UnitTest::GetInstance();
+  testing::TestEventListeners &listeners = unit_test.listeners();
+  delete listeners.Release(listeners.default_result_printer());
+  listeners.Append(new TersePrinter);
+  return RUN_ALL_TESTS();
+}
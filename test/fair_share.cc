@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <fair_share.h>
+
+namespace {
+
+class TersePrinter : public testing::EmptyTestEventListener {
+private:
+  void OnTestProgramStart(const testing::UnitTest & /* unit_test */) override {}
+
+  void OnTestProgramEnd(const testing::UnitTest &unit_test) override {
+    fprintf(stdout, "TEST %s\n", unit_test.Passed() ? "PASSED" : "FAILED");
+    fflush(stdout);
+  }
+};
+
+// grant queues waiters of each type behind the only slot, then frees the slot once for each grant. Every
+// waiter granted keeps the slot, so the waiters are served one by one in the order the scheduler picks
+// them, returns the types in that order
+std::vector<std::string> grant(FairShare &fair, const std::vector<std::string> &types, size_t total) {
+  EXPECT_TRUE(fair.acquire("hold"));
+  std::mutex locker;
+  std::vector<std::string> order;
+  std::vector<std::thread> threads;
+  for (const std::string &type : types) {
+    for (size_t i = 0; i < total; i++) {
+      threads.emplace_back([&, type]() {
+        if (fair.acquire(type)) {
+          std::lock_guard<std::mutex> lock(locker);
+          order.push_back(type);
+        }
+      });
+    }
+  }
+  while (fair.waiting() < types.size() * total) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  for (size_t step = 1; step <= total; step++) {
+    fair.release();
+    while (true) {
+      {
+        std::lock_guard<std::mutex> lock(locker);
+        if (order.size() == step) {
+          break;
+        }
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  }
+  fair.stop();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return order;
+}
+
+TEST(fair_share, weight) {
+  FairShare fair(1, {{"followers", ShareConfig{.weight = 3}}, {"commits", ShareConfig{.weight = 1}}});
+  std::vector<std::string> order = grant(fair, {"followers", "commits"}, 40);
+  ASSERT_EQ(order.size(), 40);
+  long followers = std::count(order.begin(), order.end(), "followers");
+  EXPECT_GE(followers, 29);
+  EXPECT_LE(followers, 31);
+}
+
+TEST(fair_share, min_share) {
+  FairShare fair(1, {{"followers", ShareConfig{.weight = 1, .min = 0.4}}, {"commits", ShareConfig{.weight = 9}}});
+  std::vector<std::string> order = grant(fair, {"followers", "commits"}, 100);
+  ASSERT_EQ(order.size(), 100);
+  EXPECT_GE(std::count(order.begin(), order.end(), "followers"), 35); // 10 by the weights alone
+}
+
+TEST(fair_share, hour_cap) {
+  FairShare fair(4, {{"commits", ShareConfig{.max_per_hour = 5}}});
+  for (int i = 0; i < 5; i++) {
+    ASSERT_TRUE(fair.acquire("commits"));
+    fair.release();
+  }
+  std::atomic<bool> granted = false;
+  std::atomic<bool> returned = false;
+  std::thread capped([&]() {
+    granted = fair.acquire("commits");
+    returned = true;
+  });
+  EXPECT_TRUE(fair.acquire("followers")); // the other types are not held by the capped one
+  fair.release();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_FALSE(returned);
+  fair.stop();
+  capped.join();
+  EXPECT_FALSE(granted);
+}
+
+TEST(fair_share, category) {
+  EXPECT_EQ(FairShare::category(request_type_followers), "followers");
+  EXPECT_EQ(FairShare::category(request_type_users_repos_branches_commits), "users_repos_branches_commits");
+  EXPECT_EQ(FairShare::category(request_type_license_info), "license");
+  EXPECT_TRUE(FairShare::known("users_repos_branches_commits"));
+  EXPECT_TRUE(FairShare::known("profiles"));
+  EXPECT_FALSE(FairShare::known("commits"));
+  EXPECT_FALSE(FairShare::known("unknown"));
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  testing::UnitTest &unit_test = *testing::UnitTest::GetInstance();
+  testing::TestEventListeners &listeners = unit_test.listeners();
+  delete listeners.Release(listeners.default_result_printer());
+  listeners.Append(new TersePrinter);
+  return RUN_ALL_TESTS();
+}
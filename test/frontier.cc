@@ -0,0 +1,186 @@
+#include <filesystem>
+#include <fstream>
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <frontier.h>
+
+namespace {
+
+class TersePrinter : public testing::EmptyTestEventListener {
+private:
+  void OnTestProgramStart(const testing::UnitTest & /* unit_test */) override {}
+
+  void OnTestProgramEnd(const testing::UnitTest &unit_test) override {
+    fprintf(stdout, "TEST %s\n", unit_test.Passed() ? "PASSED" : "FAILED");
+    fflush(stdout);
+  }
+};
+
+std::string frontier_dir(const std::string &name) {
+  std::string dir = (std::filesystem::temp_directory_path() / ("spider_frontier_" + name)).string();
+  std::filesystem::remove_all(dir);
+  return dir;
+}
+
+TEST(frontier, dedup) {
+  std::string dir = frontier_dir("dedup");
+  Frontier frontier(dir, "followers", 100);
+  ASSERT_EQ(frontier.open(), 0);
+  EXPECT_TRUE(frontier.push("tosone"));
+  EXPECT_FALSE(frontier.push("tosone"));
+  EXPECT_TRUE(frontier.push("octocat"));
+  EXPECT_EQ(frontier.size(), 2);
+
+  std::vector<FrontierEntry> keys = frontier.pop(10);
+  ASSERT_EQ(keys.size(), 2);
+  EXPECT_EQ(keys[0].key, "tosone");
+  EXPECT_EQ(keys[1].key, "octocat");
+  EXPECT_TRUE(frontier.push("tosone")); // popped keys may be queued again
+  EXPECT_FALSE(frontier.push(""));
+}
+
+TEST(frontier, visited) {
+  std::string dir = frontier_dir("visited");
+  Frontier frontier(dir, "followers", 2, 3600);
+  ASSERT_EQ(frontier.open(), 0);
+  EXPECT_TRUE(frontier.push("tosone"));
+  EXPECT_TRUE(frontier.seen("tosone"));
+  ASSERT_EQ(frontier.pop(10).size(), 1);
+  EXPECT_TRUE(frontier.seen("tosone"));
+  EXPECT_FALSE(frontier.push("tosone")); // crawled within the window
+
+  // no more visits than pending keys are kept, the oldest is forgotten
+  EXPECT_TRUE(frontier.push("a"));
+  EXPECT_TRUE(frontier.push("b"));
+  ASSERT_EQ(frontier.pop(10).size(), 2);
+  EXPECT_FALSE(frontier.seen("tosone"));
+  EXPECT_TRUE(frontier.seen("a"));
+  EXPECT_TRUE(frontier.push("tosone"));
+}
+
+TEST(frontier, full) {
+  std::string dir = frontier_dir("full");
+  Frontier frontier(dir, "followers", 2);
+  ASSERT_EQ(frontier.open(), 0);
+  EXPECT_TRUE(frontier.push("a"));
+  EXPECT_TRUE(frontier.push("b"));
+  EXPECT_FALSE(frontier.push("c"));
+}
+
+// a log of version 2 is upgraded on open, the pending keys keep their depth and get a score of 0
+TEST(frontier, upgrade) {
+  std::string dir = frontier_dir("upgrade");
+  std::filesystem::create_directories(dir);
+  {
+    std::ofstream out(dir + "/followers.frontier", std::ios::binary);
+    std::vector<std::pair<std::string, uint32_t>> keys = {{"popped", 1}, {"tosone", 2}, {"octocat", 5}};
+    uint64_t head = sizeof(FrontierHeader) + 3 * sizeof(uint32_t) + keys[0].first.size();
+    FrontierHeader header{0x52465053, 2, head};
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (const auto &[key, depth] : keys) {
+      uLong crc = crc32(0, reinterpret_cast<const Bytef *>(&depth), sizeof(depth));
+      crc = crc32(crc, reinterpret_cast<const Bytef *>(key.data()), key.size());
+      uint32_t record[3] = {static_cast<uint32_t>(key.size()), static_cast<uint32_t>(crc), depth};
+      out.write(reinterpret_cast<const char *>(record), sizeof(record));
+      out.write(key.data(), static_cast<std::streamsize>(key.size()));
+    }
+  }
+  {
+    Frontier frontier(dir, "followers", 100);
+    ASSERT_EQ(frontier.open(), 0);
+    EXPECT_EQ(frontier.size(), 2);
+    EXPECT_TRUE(frontier.push("after-upgrade", 1, 2.5));
+  }
+  Frontier frontier(dir, "followers", 100);
+  ASSERT_EQ(frontier.open(), 0);
+  std::vector<FrontierEntry> keys = frontier.pop(10);
+  ASSERT_EQ(keys.size(), 3);
+  EXPECT_EQ(keys[0].key, "tosone");
+  EXPECT_EQ(keys[0].depth, 2);
+  EXPECT_EQ(keys[0].score, 0);
+  EXPECT_EQ(keys[1].depth, 5);
+  EXPECT_EQ(keys[2].key, "after-upgrade");
+  EXPECT_EQ(keys[2].score, 2.5);
+}
+
+TEST(frontier, reload) {
+  std::string dir = frontier_dir("reload");
+  {
+    Frontier frontier(dir, "followers", 100);
+    ASSERT_EQ(frontier.open(), 0);
+    for (int i = 0; i < 10; i++) {
+      frontier.push("user" + std::to_string(i), i);
+    }
+    EXPECT_EQ(frontier.pop(3).size(), 3);
+    ASSERT_EQ(frontier.commit(), 0);
+    EXPECT_EQ(frontier.pop(2).size(), 2); // not committed, popped again after the restart
+  }
+  Frontier frontier(dir, "followers", 100);
+  ASSERT_EQ(frontier.open(), 0);
+  EXPECT_EQ(frontier.size(), 7);
+  std::vector<FrontierEntry> keys = frontier.pop(1);
+  ASSERT_EQ(keys.size(), 1);
+  EXPECT_EQ(keys[0].key, "user3");
+  EXPECT_EQ(keys[0].depth, 3);
+}
+
+TEST(frontier, torn_record) {
+  std::string dir = frontier_dir("torn");
+  std::string path = dir + "/followers.frontier";
+  {
+    Frontier frontier(dir, "followers", 100);
+    ASSERT_EQ(frontier.open(), 0);
+    frontier.push("first");
+    frontier.push("second");
+  }
+  { // a crash in the middle of the second record
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(sizeof(FrontierHeader) + sizeof(FrontierRecord) + 5 + sizeof(FrontierRecord) + 2);
+    file.write("X", 1);
+  }
+  Frontier frontier(dir, "followers", 100);
+  ASSERT_EQ(frontier.open(), 0);
+  EXPECT_EQ(frontier.size(), 1);
+  EXPECT_TRUE(frontier.push("third"));
+  std::vector<FrontierEntry> keys = frontier.pop(10);
+  ASSERT_EQ(keys.size(), 2);
+  EXPECT_EQ(keys[0].key, "first");
+  EXPECT_EQ(keys[1].key, "third");
+}
+
+TEST(frontier, grow_and_compact) {
+  std::string dir = frontier_dir("compact");
+  std::string path = dir + "/followers.frontier";
+  {
+    Frontier frontier(dir, "followers", 1000000);
+    ASSERT_EQ(frontier.open(), 0);
+    for (int i = 0; i < 100000; i++) {
+      ASSERT_TRUE(frontier.push(fmt::format("user-with-a-long-login-{}", i)));
+    }
+    size_t grown = std::filesystem::file_size(path);
+    EXPECT_GT(grown, 1 << 20);
+    EXPECT_EQ(frontier.pop(99000).size(), 99000);
+    ASSERT_EQ(frontier.commit(), 0);
+    EXPECT_LT(std::filesystem::file_size(path), grown);
+    EXPECT_TRUE(frontier.push("after-compact"));
+  }
+  Frontier frontier(dir, "followers", 1000000);
+  ASSERT_EQ(frontier.open(), 0);
+  EXPECT_EQ(frontier.size(), 1001);
+  std::vector<FrontierEntry> keys = frontier.pop(1);
+  ASSERT_EQ(keys.size(), 1);
+  EXPECT_EQ(keys[0].key, "user-with-a-long-login-99000");
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  testing::UnitTest &unit_test = *testing::UnitTest::GetInstance();
+  testing::TestEventListeners &listeners = unit_test.listeners();
+  delete listeners.Release(listeners.default_result_printer());
+  listeners.Append(new TersePrinter);
+  return RUN_ALL_TESTS();
+}
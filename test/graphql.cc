@@ -0,0 +1,94 @@
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <graphql.h>
+#include <tokens.h>
+
+namespace {
+
+class TersePrinter : public testing::EmptyTestEventListener {
+private:
+  void OnTestProgramStart(const testing::UnitTest & /* unit_test */) override {}
+
+  void OnTestProgramEnd(const testing::UnitTest &unit_test) override {
+    fprintf(stdout, "TEST %s\n", unit_test.Passed() ? "PASSED" : "FAILED");
+    fflush(stdout);
+  }
+};
+
+TEST(graphql_users, query) {
+  std::string query = graphql_users_query({"octocat", "a\"b"});
+  EXPECT_NE(query.find(R"(u0: user(login: "octocat") { ...user })"), std::string::npos);
+  EXPECT_NE(query.find(R"(u1: user(login: "a\"b") { ...user })"), std::string::npos);
+  EXPECT_NE(query.find("fragment user on User"), std::string::npos);
+}
+
+TEST(graphql_users, parse) {
+  std::string body = R"({"data": {
+    "u0": {"login": "octocat", "databaseId": 583231, "id": "MDQ6VXNlcjU4MzIzMQ==", "name": "The Octocat", "isHireable": true,
+           "createdAt": "2011-01-25T18:44:36Z", "followers": {"totalCount": 9000}, "repositories": {"totalCount": 8}},
+    "u1": null
+  }, "errors": [{"type": "NOT_FOUND", "path": ["u1"]}]})";
+  std::vector<User> users;
+  std::vector<std::string> missing;
+  ASSERT_EQ(graphql_users_parse(body, {"octocat", "dependabot"}, users, missing), EXIT_SUCCESS);
+  ASSERT_EQ(users.size(), 1);
+  EXPECT_EQ(users[0].id, 583231);
+  EXPECT_EQ(users[0].login, "octocat");
+  EXPECT_EQ(users[0].followers, 9000);
+  EXPECT_EQ(users[0].public_repos, 8);
+  EXPECT_TRUE(users[0].hireable);
+  EXPECT_EQ(missing, std::vector<std::string>{"dependabot"});
+}
+
+// data is null if the query fails as a whole, the batch is not sent to REST one login at a time
+TEST(graphql_users, data_null) {
+  std::vector<User> users;
+  std::vector<std::string> missing;
+  EXPECT_EQ(graphql_users_parse(R"({"data": null, "errors": [{"message": "Something went wrong"}]})", {"octocat"}, users, missing), REQUEST_ERROR);
+  EXPECT_EQ(graphql_users_parse(R"({"errors": [{"message": "Bad credentials"}]})", {"octocat"}, users, missing), REQUEST_ERROR);
+  EXPECT_EQ(graphql_users_parse("[]", {"octocat"}, users, missing), REQUEST_ERROR);
+  EXPECT_EQ(graphql_users_parse("<html>", {"octocat"}, users, missing), JSON_PARSE_ERROR);
+  EXPECT_TRUE(users.empty());
+  EXPECT_TRUE(missing.empty());
+}
+
+TEST(graphql_users, rate_limited) {
+  std::vector<User> users;
+  std::vector<std::string> missing;
+  std::string body = R"({"data": null, "errors": [{"type": "RATE_LIMITED", "message": "API rate limit exceeded"}]})";
+  EXPECT_EQ(graphql_users_parse(body, {"octocat"}, users, missing), RATE_LIMITED_ERROR);
+  EXPECT_TRUE(missing.empty());
+}
+
+// a drained token is skipped until its reset, the scheduler waits if all of them are drained
+TEST(graphql_users, drain) {
+  TokenScheduler tokens({"a", "b"}, 0);
+  int first = tokens.acquire(RESOURCE_GRAPHQL);
+  ASSERT_GE(first, 0);
+  tokens.release(first, RESOURCE_GRAPHQL);
+  tokens.drain(first, RESOURCE_GRAPHQL, GRAPHQL_RATE_LIMIT_PAUSE);
+  int second = tokens.acquire(RESOURCE_GRAPHQL);
+  EXPECT_EQ(second, 1 - first);
+  tokens.release(second, RESOURCE_GRAPHQL);
+  tokens.drain(second, RESOURCE_GRAPHQL, GRAPHQL_RATE_LIMIT_PAUSE);
+
+  std::thread stopper([&tokens]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    tokens.stop();
+  });
+  EXPECT_LT(tokens.acquire(RESOURCE_GRAPHQL), 0);
+  stopper.join();
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  testing::UnitTest &unit_test = *testing::UnitTest::GetInstance();
+  testing::TestEventListeners &listeners = unit_test.listeners();
+  delete listeners.Release(listeners.default_result_printer());
+  listeners.Append(new TersePrinter);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,97 @@
+#include <ctime>
+
+#include <gtest/gtest.h>
+
+#include <lanes.h>
+
+namespace {
+
+class TersePrinter : public testing::EmptyTestEventListener {
+private:
+  void OnTestProgramStart(const testing::UnitTest & /* unit_test */) override {}
+
+  void OnTestProgramEnd(const testing::UnitTest &unit_test) override {
+    fprintf(stdout, "TEST %s\n", unit_test.Passed() ? "PASSED" : "FAILED");
+    fflush(stdout);
+  }
+};
+
+// tokens has two tokens, the first one has a budget of 1 request a second, the second one of 10
+TokenScheduler *budgets() {
+  auto *tokens = new TokenScheduler({"a", "b"}, 0);
+  int64_t reset = std::time(nullptr) + 1000;
+  tokens->set(0, RESOURCE_CORE, 5000, 1000, reset);
+  tokens->set(1, RESOURCE_CORE, 50000, 10000, reset);
+  return tokens;
+}
+
+TEST(token_rate, per_token) {
+  TokenScheduler *tokens = budgets();
+  EXPECT_NEAR(tokens->rate(0), 1, 0.01);
+  EXPECT_NEAR(tokens->rate(1), 10, 0.1);
+  EXPECT_NEAR(tokens->rate(), 11, 0.1);
+  delete tokens;
+}
+
+TEST(lanes, follow_token) {
+  TokenScheduler *tokens = budgets();
+  Pacer shared_pacer(60000);
+  Lane shared{.fetcher = nullptr, .pacer = &shared_pacer};
+  std::vector<Lane> own;
+  for (int i = 0; i < 2; i++) {
+    own.push_back(Lane{.fetcher = new Fetcher(4, 2, 60, 1000), .pacer = new Pacer(60000)});
+  }
+  Lanes lanes(tokens, shared, own);
+  EXPECT_TRUE(lanes.split());
+
+  int token = tokens->acquire(RESOURCE_CORE);
+  ASSERT_EQ(token, 1); // the most budget left
+  EXPECT_EQ(lanes.lane(token).fetcher, own[1].fetcher);
+  EXPECT_EQ(lanes.lane(token).pacer, own[1].pacer);
+  EXPECT_EQ(lanes.lane(0).pacer, own[0].pacer);
+  tokens->release(token, RESOURCE_CORE);
+  delete tokens;
+}
+
+// each token is paced by its own budget, the slots of one token do not hold the other one back
+TEST(lanes, pace_per_token) {
+  TokenScheduler *tokens = budgets();
+  Pacer shared_pacer(60000);
+  Lanes lanes(tokens, Lane{.fetcher = nullptr, .pacer = &shared_pacer},
+              {Lane{.fetcher = nullptr, .pacer = new Pacer(60000)}, Lane{.fetcher = nullptr, .pacer = new Pacer(60000)}});
+  EXPECT_EQ(lanes.reserve(0), 0);
+  int64_t wait = lanes.reserve(0);
+  EXPECT_GE(wait, 890);
+  EXPECT_LE(wait, 1110);
+
+  EXPECT_EQ(lanes.reserve(1), 0);
+  wait = lanes.reserve(1);
+  EXPECT_GE(wait, 88);
+  EXPECT_LE(wait, 112);
+  delete tokens;
+}
+
+TEST(lanes, shared) {
+  TokenScheduler *tokens = budgets();
+  Pacer shared_pacer(60000);
+  Lanes lanes(tokens, Lane{.fetcher = nullptr, .pacer = &shared_pacer}, {});
+  EXPECT_FALSE(lanes.split());
+  EXPECT_EQ(lanes.lane(1).pacer, &shared_pacer);
+
+  EXPECT_EQ(lanes.reserve(-1), 0);
+  int64_t wait = lanes.reserve(-1); // 11 requests a second of both of the tokens
+  EXPECT_GE(wait, 80);
+  EXPECT_LE(wait, 102);
+  delete tokens;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  testing::UnitTest &unit_test = *testing::UnitTest::GetInstance();
+  testing::TestEventListeners &listeners = unit_test.listeners();
+  delete listeners.Release(listeners.default_result_printer());
+  listeners.Append(new TersePrinter);
+  return RUN_ALL_TESTS();
+}
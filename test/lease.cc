@@ -0,0 +1,136 @@
+#include <unistd.h>
+
+#include <cstdio>
+
+#include <CLI/CLI.hpp>
+#include <gtest/gtest.h>
+
+#include <database/mongo.h>
+
+std::string dsn;
+std::string worker; // owner of the leases when the test runs as one of the replicas
+std::string queue = fmt::format("lease_test_{}", getpid());
+
+const int LEASE_KEYS = 1000;
+const int LEASE_REPLICAS = 4;
+
+namespace {
+
+class TersePrinter : public testing::EmptyTestEventListener {
+private:
+  void OnTestProgramStart(const testing::UnitTest & /* unit_test */) override {}
+
+  void OnTestProgramEnd(const testing::UnitTest &unit_test) override {
+    fprintf(stdout, "TEST %s\n", unit_test.Passed() ? "PASSED" : "FAILED");
+    fflush(stdout);
+  }
+};
+
+std::vector<std::string> lease_keys(int from, int to) {
+  std::vector<std::string> keys;
+  for (int i = from; i < to; i++) {
+    keys.push_back(fmt::format("user{}", i));
+  }
+  return keys;
+}
+
+// claim returns the keys the owner holds, the claim must not fail
+std::vector<std::string> claim(Mongo *mongo, const std::string &name, const std::vector<std::string> &keys, const std::string &owner, int64_t ttl) {
+  std::vector<std::string> claimed;
+  EXPECT_EQ(mongo->claim_leases(name, keys, owner, ttl, claimed), 0);
+  return claimed;
+}
+
+// replica claims all of the keys in batches like a crawl queue and prints the keys it got
+int replica() {
+  spdlog::set_level(spdlog::level::warn);
+  Mongo *mongo = new Mongo(dsn);
+  if (mongo->initialize() != 0) {
+    return EXIT_FAILURE;
+  }
+  for (int from = 0; from < LEASE_KEYS; from += 100) {
+    std::vector<std::string> claimed;
+    if (mongo->claim_leases(queue, lease_keys(from, from + 100), worker, 60, claimed) != 0) {
+      return EXIT_FAILURE;
+    }
+    for (const std::string &key : claimed) {
+      fprintf(stdout, "%s\n", key.c_str());
+      if (mongo->finish_lease(queue, key, worker, 60) != 0) {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  fflush(stdout);
+  delete mongo;
+  return EXIT_SUCCESS;
+}
+
+TEST(lease, replicas) {
+  std::vector<FILE *> replicas;
+  for (int i = 0; i < LEASE_REPLICAS; i++) {
+    std::string command = fmt::format("/proc/{}/exe --dsn '{}' --queue {} --worker replica{}", getpid(), dsn, queue, i);
+    FILE *pipe = popen(command.c_str(), "r");
+    ASSERT_NE(pipe, nullptr);
+    replicas.push_back(pipe);
+  }
+  std::map<std::string, int> claimed;
+  for (FILE *pipe : replicas) {
+    char line[256];
+    while (fgets(line, sizeof(line), pipe) != nullptr) {
+      std::string key(line);
+      boost::algorithm::trim(key);
+      if (key.starts_with("user")) { // the rest is the log of the replica
+        claimed[key]++;
+      }
+    }
+    EXPECT_EQ(pclose(pipe), 0);
+  }
+  EXPECT_EQ(claimed.size(), LEASE_KEYS);
+  for (const auto &[key, count] : claimed) {
+    EXPECT_EQ(count, 1) << key << " is crawled by several replicas";
+  }
+}
+
+TEST(lease, expire) {
+  Mongo *mongo = new Mongo(dsn);
+  ASSERT_EQ(mongo->initialize(), 0);
+  std::string expire_queue = queue + "_expire";
+  std::string alive = queue + "_alive", dead = queue + "_dead", other = queue + "_other";
+  std::vector<std::string> keys = lease_keys(0, 10);
+
+  EXPECT_EQ(claim(mongo, expire_queue, keys, alive, 60).size(), 10);
+  EXPECT_EQ(claim(mongo, expire_queue, keys, alive, 60).size(), 10); // the owner claims its keys again
+  EXPECT_TRUE(claim(mongo, expire_queue, keys, other, 60).empty());
+
+  EXPECT_EQ(claim(mongo, expire_queue + "_dead", keys, dead, 1).size(), 10);
+  std::this_thread::sleep_for(std::chrono::seconds(2)); // dead stops renewing its leases
+  EXPECT_EQ(claim(mongo, expire_queue + "_dead", keys, other, 60).size(), 10);
+
+  EXPECT_EQ(mongo->finish_lease(expire_queue, keys[0], alive, 60), 0);
+  EXPECT_EQ(mongo->release_leases(alive), 0);
+  std::vector<std::string> released = claim(mongo, expire_queue, keys, other, 60);
+  EXPECT_EQ(released.size(), 9); // the crawled key is held for the other replicas
+  EXPECT_EQ(std::count(released.begin(), released.end(), keys[0]), 0);
+  delete mongo;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  CLI::App app{"MongoDB lease test"};
+  app.add_option("--dsn", dsn, "mongodb dsn");
+  app.add_option("--queue", queue, "crawl queue of the leases");
+  app.add_option("--worker", worker, "run as the replica with the owner");
+  CLI11_PARSE(app, argc, argv)
+
+  if (!worker.empty()) {
+    return replica();
+  }
+
+  testing::UnitTest &unit_test = *testing::UnitTest::GetInstance();
+  testing::TestEventListeners &listeners = unit_test.listeners();
+  delete listeners.Release(listeners.default_result_printer());
+  listeners.Append(new TersePrinter);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <link.h>
+
+namespace {
+
+class TersePrinter : public testing::EmptyTestEventListener {
+private:
+  void OnTestProgramStart(const testing::UnitTest & /* unit_test */) override {}
+
+  void OnTestProgramEnd(const testing::UnitTest &unit_test) override {
+    fprintf(stdout, "TEST %s\n", unit_test.Passed() ? "PASSED" : "FAILED");
+    fflush(stdout);
+  }
+};
+
+TEST(parse_link, normal) {
+  std::string header = R"(<https://api.github.com/user/1/followers?per_page=100&page=2>; rel="next", <https://api.github.com/user/1/followers?per_page=100&page=34>; rel="last")";
+  LinkHeader link = parse_link(header);
+  EXPECT_EQ(link.next, "https://api.github.com/user/1/followers?per_page=100&page=2");
+  EXPECT_EQ(link.last, "https://api.github.com/user/1/followers?per_page=100&page=34");
+  EXPECT_TRUE(link.prev.empty());
+  EXPECT_TRUE(link.first.empty());
+  EXPECT_EQ(link_page(link.last), 34);
+}
+
+TEST(parse_link, last_page) {
+  std::string header = R"(<https://api.github.com/user/1/repos?page=1>; rel="first", <https://api.github.com/user/1/repos?page=33>; rel="prev")";
+  LinkHeader link = parse_link(header);
+  EXPECT_TRUE(link.next.empty());
+  EXPECT_EQ(link_page(link.first), 1);
+  EXPECT_EQ(link_page(link.prev), 33);
+}
+
+TEST(parse_link, any_host) {
+  std::string header = R"(<https://ghe.example.com:8443/api/v3/orgs/x/repos?page=3&per_page=100>;rel=next)";
+  LinkHeader link = parse_link(header);
+  EXPECT_EQ(link.next, "https://ghe.example.com:8443/api/v3/orgs/x/repos?page=3&per_page=100");
+
+  std::string_view origin, path;
+  split_url(link.next, origin, path);
+  EXPECT_EQ(origin, "https://ghe.example.com:8443");
+  EXPECT_EQ(path, "/api/v3/orgs/x/repos?page=3&per_page=100");
+  EXPECT_EQ(link_page(path), 3);
+}
+
+TEST(link_with_page, normal) {
+  EXPECT_EQ(link_with_page("/user/1/followers?per_page=100&page=2", 7), "/user/1/followers?per_page=100&page=7");
+  EXPECT_EQ(link_with_page("/user/1/followers?page=2&per_page=100", 12), "/user/1/followers?page=12&per_page=100");
+  EXPECT_EQ(link_with_page("/user/1/followers?per_page=100", 3), "/user/1/followers?per_page=100&page=3");
+  EXPECT_EQ(link_with_page("/user/1/followers", 3), "/user/1/followers?page=3");
+  EXPECT_EQ(link_with_page("/search/users?q=a&xpage=1", 2), "/search/users?q=a&xpage=1&page=2");
+}
+
+TEST(parse_link, invalid) {
+  EXPECT_TRUE(parse_link("").next.empty());
+  EXPECT_TRUE(parse_link("<https://api.github.com/users?page=2").next.empty());
+  EXPECT_TRUE(parse_link(R"(<https://api.github.com/users?page=2>; title="next")").next.empty());
+  EXPECT_EQ(link_page("/users?since=100"), 0);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  testing::UnitTest &unit_test = *testing::UnitTest::GetInstance();
+  testing::TestEventListeners &listeners = unit_test.listeners();
+  delete listeners.Release(listeners.default_result_printer());
+  listeners.Append(new TersePrinter);
+  return RUN_ALL_TESTS();
+}
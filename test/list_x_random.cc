@@ -1,9 +1,15 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <thread>
+
 #include <CLI/CLI.hpp>
 #include <gtest/gtest.h>
 
 #include <database/mongo.h>
 
 std::string dsn;
+int64_t base_id = 2000000000000 + getpid() * 100; // far from the ids of github, unique for the run
 
 namespace {
 
@@ -29,6 +35,62 @@ TEST(list_x_random, normal) {
     spdlog::info("item: {}", item);
   }
 }
+
+User make_user(int64_t offset) {
+  return User{.id = base_id + offset, .login = fmt::format("list_x_random_test_{}", base_id + offset)};
+}
+
+// sampled returns true if the login is in one of a few samples of the followers crawl, the samples are random
+bool sampled(Mongo *mongo, const std::string &login, int times = 20) {
+  for (int i = 0; i < times; i++) {
+    std::vector<std::string> result = mongo->list_users_random(request_type_followers);
+    if (std::find(result.begin(), result.end(), login) != result.end()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// a due user is sampled whichever pass the crawl type is in, once until it falls due again, a user not due is not
+TEST(list_x_random, due) {
+  Mongo *mongo = new Mongo(dsn);
+  EXPECT_EQ(mongo->initialize(), 0);
+
+  User due = make_user(0);
+  User later = make_user(1);
+  EXPECT_EQ(mongo->upsert_user(due), 0);
+  EXPECT_EQ(mongo->upsert_user(later), 0);
+  EXPECT_EQ(mongo->observe_revisits("users", {{due.login, "2021-09-12T13:13:00Z"}}, 0, 0), 0);
+  EXPECT_EQ(mongo->observe_revisits("users", {{later.login, "2021-09-12T13:13:00Z"}}, 3600, 3600), 0);
+
+  EXPECT_TRUE(sampled(mongo, due.login));
+  EXPECT_FALSE(sampled(mongo, due.login, 3)); // visited since it fell due
+  EXPECT_FALSE(sampled(mongo, later.login));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(mongo->observe_revisits("users", {{due.login, "2021-09-13T13:13:00Z"}}, 0, 0), 0);
+  EXPECT_TRUE(sampled(mongo, due.login));
+}
+
+// observe_revisits keeps one history for each entity, the visits of several keys are written at once
+TEST(list_x_random, observe_revisits) {
+  Mongo *mongo = new Mongo(dsn);
+  EXPECT_EQ(mongo->initialize(), 0);
+
+  User first = make_user(2);
+  User second = make_user(3);
+  EXPECT_EQ(mongo->upsert_user(first), 0);
+  EXPECT_EQ(mongo->upsert_user(second), 0);
+  EXPECT_EQ(mongo->observe_revisits("users", {}, 0, 0), 0);
+  EXPECT_EQ(mongo->observe_revisits("users", {{first.login, "2021-09-12T13:13:00Z"}, {second.login, "2021-09-12T13:13:00Z"}}, 3600, 3600), 0);
+  EXPECT_FALSE(sampled(mongo, first.login));
+  EXPECT_FALSE(sampled(mongo, second.login));
+
+  // the history of the first one is rescheduled only, the second one still waits for an hour
+  EXPECT_EQ(mongo->observe_revisits("users", {{first.login, "2021-09-12T13:13:00Z"}}, 0, 0), 0);
+  EXPECT_TRUE(sampled(mongo, first.login));
+  EXPECT_FALSE(sampled(mongo, second.login));
+}
 } // namespace
 
 int main(int argc, char **argv) {
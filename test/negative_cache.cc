@@ -0,0 +1,77 @@
+#include <ctime>
+
+#include <gtest/gtest.h>
+
+#include <negative_cache.h>
+
+namespace {
+
+class TersePrinter : public testing::EmptyTestEventListener {
+private:
+  void OnTestProgramStart(const testing::UnitTest & /* unit_test */) override {}
+
+  void OnTestProgramEnd(const testing::UnitTest &unit_test) override {
+    fprintf(stdout, "TEST %s\n", unit_test.Passed() ? "PASSED" : "FAILED");
+    fflush(stdout);
+  }
+};
+
+void expect_entity(const std::string &path, const std::string &collection, const std::string &key, bool owned = true) {
+  std::string c, k;
+  EXPECT_EQ(NegativeCache::entity(path, c, k), owned) << path;
+  EXPECT_EQ(c, collection) << path;
+  EXPECT_EQ(k, key) << path;
+}
+
+TEST(negative_cache, entity) {
+  expect_entity("/users/octocat", "users", "octocat");
+  expect_entity("/users/octocat/followers?per_page=100&page=3", "users", "octocat");
+  expect_entity("/orgs/github/public_members?per_page=100", "orgs", "github");
+  expect_entity("/repos/octocat/Hello-World/branches?per_page=100", "repos", "octocat/Hello-World");
+  expect_entity("/repos/octocat", "", "/repos/octocat");
+  expect_entity("/licenses/mit", "", "/licenses/mit");
+  expect_entity("/users", "", "/users");
+}
+
+// a 404 under the entity that is not one of its lists says nothing about the entity
+TEST(negative_cache, sub_resource) {
+  expect_entity("/repos/octocat/Hello-World", "repos", "octocat/Hello-World");
+  expect_entity("/repos/octocat/Hello-World/stargazers?page=2&per_page=100", "repos", "octocat/Hello-World");
+  expect_entity("/repos/octocat/Hello-World/commits?sha=gone&per_page=100", "repos", "octocat/Hello-World", false);
+  expect_entity("/repos/octocat/Hello-World/issues/1", "repos", "octocat/Hello-World", false);
+  expect_entity("/repos/octocat/Hello-World/contents/README.md", "repos", "octocat/Hello-World", false);
+  expect_entity("/users/octocat/starred/", "users", "octocat");
+}
+
+TEST(negative_cache, expire) {
+  NegativeCache cache;
+  cache.put(Negative{.collection = "users", .key = "ghost", .status = 404, .expire_at = std::time(nullptr) + 60});
+  cache.put(Negative{.collection = "repos", .key = "a/b", .status = 451, .expire_at = std::time(nullptr) - 1});
+  EXPECT_TRUE(cache.dead("users", "ghost"));
+  EXPECT_FALSE(cache.dead("orgs", "ghost"));
+  EXPECT_FALSE(cache.dead("repos", "a/b"));
+  EXPECT_FALSE(cache.dead("users", "octocat"));
+}
+
+TEST(negative_cache, load) {
+  NegativeCache cache;
+  prometheus::Counter &found = Metrics::counter("spider_negative_entries_total", "Entities found dead", {{"status", "404"}});
+  double before = found.Value();
+  cache.load(Negative{.collection = "users", .key = "ghost", .status = 404, .expire_at = std::time(nullptr) + 60});
+  EXPECT_EQ(found.Value(), before);
+  cache.put(Negative{.collection = "users", .key = "gone", .status = 404, .expire_at = std::time(nullptr) + 60});
+  EXPECT_EQ(found.Value(), before + 1);
+  EXPECT_TRUE(cache.dead("users", "ghost"));
+  EXPECT_TRUE(cache.dead("users", "gone"));
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  testing::UnitTest &unit_test = *testing::UnitTest::GetInstance();
+  testing::TestEventListeners &listeners = unit_test.listeners();
+  delete listeners.Release(listeners.default_result_printer());
+  listeners.Append(new TersePrinter);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <pacer.h>
+
+namespace {
+
+class TersePrinter : public testing::EmptyTestEventListener {
+private:
+  void OnTestProgramStart(const testing::UnitTest & /* unit_test */) override {}
+
+  void OnTestProgramEnd(const testing::UnitTest &unit_test) override {
+    fprintf(stdout, "TEST %s\n", unit_test.Passed() ? "PASSED" : "FAILED");
+    fflush(stdout);
+  }
+};
+
+// gap returns the milliseconds between two slots taken one after the other
+int64_t gap(Pacer &pacer, double rate) {
+  int64_t first = pacer.reserve(rate);
+  return pacer.reserve(rate) - first;
+}
+
+void expect_gap(Pacer &pacer, double interval) {
+  int64_t wait = gap(pacer, 10);
+  EXPECT_GE(wait, static_cast<int64_t>(interval * 0.9) - 2);
+  EXPECT_LE(wait, static_cast<int64_t>(interval * 1.1) + 2);
+}
+
+TEST(pacer, spread) {
+  Pacer pacer(60000);
+  EXPECT_EQ(pacer.reserve(2), 0); // the first slot is now
+  int64_t wait = pacer.reserve(2);
+  EXPECT_GE(wait, 440);
+  EXPECT_LE(wait, 560);
+  wait = pacer.reserve(2);
+  EXPECT_GE(wait, 890);
+  EXPECT_LE(wait, 1110);
+}
+
+TEST(pacer, max_interval) {
+  Pacer pacer(100);
+  pacer.reserve(0.001);
+  EXPECT_LE(pacer.reserve(0.001), 100);
+  pacer.reserve(0);
+  EXPECT_LE(pacer.reserve(0), 300);
+}
+
+TEST(pacer, aimd) {
+  Pacer pacer(60000);
+  pacer.observe(false, 100);
+  expect_gap(pacer, 100);
+  pacer.observe(true, 100);
+  pacer.observe(true, 100);
+  expect_gap(pacer, 400);
+  pacer.observe(false, 100);
+  expect_gap(pacer, 390);
+  pacer.observe(false, 5000); // latency spike
+  expect_gap(pacer, 585);
+  for (int i = 0; i < 100; i++) {
+    pacer.observe(false, 100);
+  }
+  expect_gap(pacer, 100);
+  for (int i = 0; i < 100; i++) {
+    pacer.observe(true, 100);
+  }
+  expect_gap(pacer, 6400);
+}
+
+// the backoff stretches the interval beyond max_interval, max_interval only bounds the budget rate
+TEST(pacer, backoff_over_max_interval) {
+  Pacer pacer(100);
+  expect_gap(pacer, 100);
+  pacer.observe(true, 100);
+  pacer.observe(true, 100);
+  pacer.observe(true, 100);
+  int64_t wait = gap(pacer, 0.001);
+  EXPECT_GE(wait, 718);
+  EXPECT_LE(wait, 882);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  testing::UnitTest &unit_test = *testing::UnitTest::GetInstance();
+  testing::TestEventListeners &listeners = unit_test.listeners();
+  delete listeners.Release(listeners.default_result_printer());
+  listeners.Append(new TersePrinter);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,162 @@
+#include <filesystem>
+#include <fstream>
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <priority.h>
+
+namespace {
+
+class TersePrinter : public testing::EmptyTestEventListener {
+private:
+  void OnTestProgramStart(const testing::UnitTest & /* unit_test */) override {}
+
+  void OnTestProgramEnd(const testing::UnitTest &unit_test) override {
+    fprintf(stdout, "TEST %s\n", unit_test.Passed() ? "PASSED" : "FAILED");
+    fflush(stdout);
+  }
+};
+
+std::string frontier_dir(const std::string &name) {
+  std::string dir = (std::filesystem::temp_directory_path() / ("spider_priority_" + name)).string();
+  std::filesystem::remove_all(dir);
+  return dir;
+}
+
+TEST(priority, score) {
+  User star{.login = "star", .public_repos = 300, .followers = 100000};
+  User bot{.login = "bot", .public_repos = 0, .followers = 0};
+  EXPECT_GT(Priority::user(star, 1), Priority::user(bot, 1));
+  EXPECT_GT(Priority::user(star, 1), Priority::user(star, 4));
+  EXPECT_EQ(Priority::band(Priority::user(star, 1)), PRIORITY_BANDS - 1);
+  EXPECT_EQ(Priority::band(Priority::user(bot, 1)), 0);
+
+  Repo popular{.name = "spider", .stargazers_count = 5000, .forks_count = 300};
+  EXPECT_EQ(Priority::band(Priority::repo(popular, 0)), PRIORITY_BANDS - 1);
+  EXPECT_EQ(Priority::band(Priority::inherit(2.2)), 1);
+  EXPECT_EQ(Priority::band(-3), 0);
+  EXPECT_EQ(Priority::band(NAN), 0);
+}
+
+TEST(priority_frontier, highest_first) {
+  PriorityFrontier frontier(frontier_dir("highest"), "followers", 1000);
+  ASSERT_EQ(frontier.open(), 0);
+  for (int i = 0; i < 100; i++) {
+    frontier.push("low" + std::to_string(i), 0, 5);
+    frontier.push("high" + std::to_string(i), 3.5, 1);
+  }
+  EXPECT_FALSE(frontier.push("high1", 0, 5)); // waiting in a higher band
+  EXPECT_TRUE(frontier.push("low1", 3.5, 1));  // moved up from the lowest band
+  EXPECT_EQ(frontier.size(), 200);
+
+  std::vector<FrontierEntry> entries = frontier.pop(90);
+  ASSERT_EQ(entries.size(), 90);
+  size_t high = 0;
+  for (const FrontierEntry &entry : entries) {
+    if (entry.band == PRIORITY_BANDS - 1) {
+      high++;
+      EXPECT_EQ(entry.depth, 1);
+    }
+  }
+  EXPECT_EQ(high, 80); // 8 of the 9 weights
+  EXPECT_EQ(entries.front().key, "high0");
+
+  entries = frontier.pop(1000);
+  EXPECT_EQ(entries.size(), 110);
+  EXPECT_EQ(std::count_if(entries.begin(), entries.end(), [](const FrontierEntry &entry) { return entry.key == "low1"; }), 1);
+  EXPECT_EQ(frontier.size(), 0);
+}
+
+TEST(priority_frontier, low_band_served) {
+  PriorityFrontier frontier(frontier_dir("low"), "followers", 1000);
+  ASSERT_EQ(frontier.open(), 0);
+  for (int i = 0; i < 500; i++) {
+    frontier.push("high" + std::to_string(i), 3, 1);
+  }
+  frontier.push("low", 0, 1);
+  bool served = false;
+  for (const FrontierEntry &entry : frontier.pop(10)) {
+    served = served || entry.key == "low";
+  }
+  EXPECT_TRUE(served);
+}
+
+// legacy writes a log of version 1 with the keys after its head
+void legacy(const std::string &dir, const std::string &name, const std::vector<std::string> &keys) {
+  std::filesystem::create_directories(dir);
+  std::ofstream out(dir + "/" + name + ".frontier", std::ios::binary);
+  FrontierHeader header{0x52465053, 1, sizeof(FrontierHeader)};
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  for (const std::string &key : keys) {
+    uint32_t record[2] = {static_cast<uint32_t>(key.size()), static_cast<uint32_t>(crc32(0, reinterpret_cast<const Bytef *>(key.data()), key.size()))};
+    out.write(reinterpret_cast<const char *>(record), sizeof(record));
+    out.write(key.data(), static_cast<std::streamsize>(key.size()));
+  }
+}
+
+TEST(priority_frontier, migrate) {
+  std::string dir = frontier_dir("migrate");
+  legacy(dir, "followers", {"tosone", "octocat"});
+  {
+    PriorityFrontier frontier(dir, "followers", 1000);
+    ASSERT_EQ(frontier.open(), 0);
+    EXPECT_EQ(frontier.size(), 2);
+  }
+  EXPECT_FALSE(std::filesystem::exists(dir + "/followers.frontier"));
+
+  PriorityFrontier frontier(dir, "followers", 1000); // the keys are in band 0 now
+  ASSERT_EQ(frontier.open(), 0);
+  std::vector<FrontierEntry> entries = frontier.pop(10);
+  ASSERT_EQ(entries.size(), 2);
+  EXPECT_EQ(entries[0].key, "tosone");
+  EXPECT_EQ(entries[0].band, 0);
+  EXPECT_EQ(entries[0].depth, PRIORITY_SAMPLED_DEPTH);
+}
+
+// a band log of another version is not read as this one
+TEST(priority_frontier, version) {
+  std::string dir = frontier_dir("version");
+  legacy(dir, "followers.0", {"tosone"});
+  PriorityFrontier frontier(dir, "followers", 1000);
+  EXPECT_NE(frontier.open(), 0);
+}
+
+TEST(priority_frontier, visited) {
+  PriorityFrontier frontier(frontier_dir("visited"), "followers", 1000, 3600);
+  ASSERT_EQ(frontier.open(), 0);
+  EXPECT_TRUE(frontier.push("tosone", 0, 1));
+  ASSERT_EQ(frontier.pop(10).size(), 1);
+  EXPECT_FALSE(frontier.push("tosone", 3, 1)); // crawled lately from another band
+  EXPECT_EQ(frontier.size(), 0);
+}
+
+// a batch that could not be claimed goes back into its bands, the visits do not hold it back
+TEST(priority_frontier, requeue) {
+  PriorityFrontier frontier(frontier_dir("requeue"), "followers", 1000, 3600);
+  ASSERT_EQ(frontier.open(), 0);
+  frontier.push("low", 0, 4);
+  frontier.push("high", 3.5, 1);
+  std::vector<FrontierEntry> entries = frontier.pop(10);
+  ASSERT_EQ(entries.size(), 2);
+  frontier.requeue(entries);
+  EXPECT_EQ(frontier.size(), 2);
+  entries = frontier.pop(10);
+  ASSERT_EQ(entries.size(), 2);
+  EXPECT_EQ(entries[0].key, "high");
+  EXPECT_EQ(entries[0].band, PRIORITY_BANDS - 1);
+  EXPECT_EQ(entries[0].score, 3.5); // the score is kept, not only its band
+  EXPECT_EQ(entries[1].key, "low");
+  EXPECT_EQ(entries[1].depth, 4);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  testing::UnitTest &unit_test = *testing::UnitTest::GetInstance();
+  testing::TestEventListeners &listeners = unit_test.listeners();
+  delete listeners.Release(listeners.default_result_printer());
+  listeners.Append(new TersePrinter);
+  return RUN_ALL_TESTS();
+}
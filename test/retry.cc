@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <retry.h>
+
+namespace {
+
+class TersePrinter : public testing::EmptyTestEventListener {
+private:
+  void OnTestProgramStart(const testing::UnitTest & /* unit_test */) override {}
+
+  void OnTestProgramEnd(const testing::UnitTest &unit_test) override {
+    fprintf(stdout, "TEST %s\n", unit_test.Passed() ? "PASSED" : "FAILED");
+    fflush(stdout);
+  }
+};
+
+TEST(retry_policy, classify) {
+  EXPECT_EQ(RetryPolicy::classify(200, {}, ""), retry_none);
+  EXPECT_EQ(RetryPolicy::classify(404, {}, ""), retry_none);
+  EXPECT_EQ(RetryPolicy::classify(0, {}, ""), retry_transport);
+  EXPECT_EQ(RetryPolicy::classify(502, {}, ""), retry_server);
+  EXPECT_EQ(RetryPolicy::classify(403, {{"x-ratelimit-remaining", "0"}}, ""), retry_primary);
+  EXPECT_EQ(RetryPolicy::classify(429, {{"X-RateLimit-Remaining", "4000"}, {"Retry-After", "30"}}, ""), retry_secondary);
+  EXPECT_EQ(RetryPolicy::classify(403, {{"X-RateLimit-Remaining", "4000"}}, R"({"message": "You have exceeded a secondary rate limit."})"), retry_secondary);
+  EXPECT_EQ(RetryPolicy::classify(403, {{"X-RateLimit-Remaining", "4000"}}, R"({"message": "Repository access blocked"})"), retry_none);
+}
+
+TEST(retry_policy, endpoint) {
+  EXPECT_EQ(RetryPolicy::endpoint("/users/octocat"), "/users/:id");
+  EXPECT_EQ(RetryPolicy::endpoint("/users/octocat/followers?per_page=100&page=2"), "/users/:id/followers");
+  EXPECT_EQ(RetryPolicy::endpoint("/orgs/github/public_members"), "/orgs/:id/public_members");
+  EXPECT_EQ(RetryPolicy::endpoint("/repos/octocat/Hello-World/branches"), "/repos/:id/:id/branches");
+  EXPECT_EQ(RetryPolicy::endpoint("/repos/octocat/Hello-World/branches/main/protection"), "/repos/:id/:id/branches/:id/protection");
+  EXPECT_EQ(RetryPolicy::endpoint("/emojis"), "/emojis");
+  EXPECT_EQ(RetryPolicy::endpoint(""), "/");
+}
+
+TEST(retry_policy, backoff) {
+  RetryPolicy policy(3, 1, 5, 1000);
+  EXPECT_EQ(policy.backoff(retry_none, 0, {}), -1);
+  EXPECT_EQ(policy.backoff(retry_primary, 0, {}), -1);
+  int64_t delay = policy.backoff(retry_server, 2, {});
+  EXPECT_GE(delay, 0);
+  EXPECT_LE(delay, 4000);
+  delay = policy.backoff(retry_secondary, 0, {});
+  EXPECT_GE(delay, 60000);
+  delay = policy.backoff(retry_server, 0, {{"Retry-After", "7"}});
+  EXPECT_GE(delay, 7000);
+  EXPECT_LE(delay, 8000);
+  EXPECT_EQ(policy.backoff(retry_server, 3, {}), -1);
+}
+
+TEST(retry_policy, delays) {
+  RetryPolicy policy(10, 1, 5, 1000, 100, 300);
+  for (int64_t attempt = 0; attempt < 10; attempt++) {
+    policy.record("/users/:id", retry_none); // each request earns one retry
+    policy.record("/users/:id", retry_none);
+    int64_t delay = policy.backoff(retry_server, attempt, {});
+    EXPECT_GE(delay, 0);
+    EXPECT_LE(delay, std::min<int64_t>(100 << attempt, 300));
+    EXPECT_LE(policy.backoff(retry_transport, attempt, {}), 150);
+  }
+}
+
+TEST(retry_policy, budget) {
+  RetryPolicy policy(100, 0, 5, 1000);
+  int64_t retries = 0;
+  while (policy.backoff(retry_transport, 0, {}) >= 0) {
+    retries++;
+  }
+  EXPECT_EQ(retries, 10);
+  policy.record("/users/:id", retry_none);
+  EXPECT_EQ(policy.backoff(retry_transport, 0, {}), -1);
+
+  RetryPolicy earning(100, 0.5, 5, 1000);
+  for (int i = 0; i < 20; i++) {
+    earning.record("/users/:id", retry_none);
+  }
+  retries = 0;
+  while (earning.backoff(retry_transport, 0, {}) >= 0) {
+    retries++;
+  }
+  EXPECT_EQ(retries, 20);
+}
+
+TEST(retry_policy, breaker) {
+  RetryPolicy policy(3, 0.1, 3, 200);
+  const std::string endpoint = "/users/:id";
+  for (int i = 0; i < 2; i++) {
+    policy.record(endpoint, retry_server);
+    EXPECT_TRUE(policy.allow(endpoint));
+  }
+  policy.record(endpoint, retry_transport);
+  EXPECT_FALSE(policy.allow(endpoint));
+  EXPECT_TRUE(policy.allow("/orgs/:id"));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(250));
+  EXPECT_TRUE(policy.allow(endpoint)); // the probe
+  EXPECT_FALSE(policy.allow(endpoint));
+  policy.record(endpoint, retry_server);
+  EXPECT_FALSE(policy.allow(endpoint));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(250));
+  EXPECT_TRUE(policy.allow(endpoint));
+  policy.record(endpoint, retry_none);
+  EXPECT_TRUE(policy.allow(endpoint));
+  EXPECT_TRUE(policy.allow(endpoint));
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  testing::UnitTest &unit_test = *testing::UnitTest::GetInstance();
+  testing::TestEventListeners &listeners = unit_test.listeners();
+  delete listeners.Release(listeners.default_result_printer());
+  listeners.Append(new TersePrinter);
+  return RUN_ALL_TESTS();
+}
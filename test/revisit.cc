@@ -0,0 +1,90 @@
+#include <fmt/core.h>
+#include <gtest/gtest.h>
+
+#include <revisit.h>
+
+const int64_t HOUR = 3600;
+const int64_t DAY = 24 * HOUR;
+
+namespace {
+
+class TersePrinter : public testing::EmptyTestEventListener {
+private:
+  void OnTestProgramStart(const testing::UnitTest & /* unit_test */) override {}
+
+  void OnTestProgramEnd(const testing::UnitTest &unit_test) override {
+    fprintf(stdout, "TEST %s\n", unit_test.Passed() ? "PASSED" : "FAILED");
+    fflush(stdout);
+  }
+};
+
+TEST(revisit, time) {
+  EXPECT_EQ(revisit_time("1970-01-01T00:00:00Z"), 0);
+  EXPECT_EQ(revisit_time("2021-09-12T13:13:00Z"), 1631452380);
+  EXPECT_EQ(revisit_time("2021-02-30T13:13:00Z"), 0);
+  EXPECT_EQ(revisit_time(""), 0);
+}
+
+TEST(revisit, interval) {
+  EXPECT_EQ(revisit_interval(0, HOUR, 30 * DAY), 30 * DAY);
+  EXPECT_EQ(revisit_interval(1, HOUR, 30 * DAY), HOUR);
+  EXPECT_EQ(revisit_interval(1.0 / DAY, HOUR, 30 * DAY), static_cast<int64_t>(std::log(2) * DAY));
+}
+
+// first visit is scheduled by the age of the last change, a dormant account waits the longest
+TEST(revisit, first) {
+  int64_t now = revisit_time("2021-09-12T00:00:00Z");
+  Revisit active, dormant, unknown;
+  revisit_observe(active, "2021-09-11T00:00:00Z", now, HOUR, 30 * DAY);
+  revisit_observe(dormant, "2015-01-01T00:00:00Z", now, HOUR, 30 * DAY);
+  revisit_observe(unknown, "", now, HOUR, 30 * DAY);
+  EXPECT_EQ(active.next_at - now, static_cast<int64_t>(std::log(2) * DAY));
+  EXPECT_EQ(dormant.next_at - now, 30 * DAY);
+  EXPECT_EQ(unknown.next_at - now, 30 * DAY);
+  EXPECT_EQ(active.visits, 0);
+}
+
+// the estimate follows the changes seen between the visits
+TEST(revisit, rate) {
+  int64_t now = revisit_time("2021-09-12T00:00:00Z");
+  Revisit fast, slow;
+  for (int i = 0; i < 20; i++) {
+    now += 6 * HOUR;
+    revisit_observe(fast, fmt::format("2021-09-12T00:00:{:02}Z", i), now, HOUR, 30 * DAY); // changed on every visit
+    revisit_observe(slow, i % 10 == 0 ? fmt::format("2021-09-12T00:00:{:02}Z", i) : slow.last_change, now, HOUR, 30 * DAY);
+  }
+  EXPECT_EQ(fast.visits, 19);
+  EXPECT_EQ(fast.changes, 19);
+  EXPECT_EQ(slow.changes, 1);
+  EXPECT_GT(fast.rate, slow.rate * 5);
+  EXPECT_LT(fast.next_at - now, 6 * HOUR);
+  EXPECT_GT(slow.next_at - now, 6 * HOUR * 5);
+  EXPECT_NEAR(slow.rate, -std::log(18.5 / 19.5) / (6 * HOUR), 1e-12);
+}
+
+TEST(revisit, history) {
+  int64_t now = 1000;
+  Revisit revisit;
+  for (int i = 0; i < 100; i++) {
+    now += HOUR;
+    revisit_observe(revisit, std::to_string(i), now, 60, 30 * DAY);
+  }
+  EXPECT_LE(revisit.visits, REVISIT_HISTORY);
+  for (int i = 0; i < 100; i++) { // stopped changing, the older changes fade out
+    now += HOUR;
+    revisit_observe(revisit, "99", now, 60, 30 * DAY);
+  }
+  EXPECT_LT(revisit.changes, 2);
+  EXPECT_GT(revisit.next_at - now, 10 * HOUR);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  testing::UnitTest &unit_test = *testing::UnitTest::GetInstance();
+  testing::TestEventListeners &listeners = unit_test.listeners();
+  delete listeners.Release(listeners.default_result_printer());
+  listeners.Append(new TersePrinter);
+  return RUN_ALL_TESTS();
+}
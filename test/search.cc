@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <search.h>
+
+namespace {
+
+class TersePrinter : public testing::EmptyTestEventListener {
+private:
+  void OnTestProgramStart(const testing::UnitTest & /* unit_test */) override {}
+
+  void OnTestProgramEnd(const testing::UnitTest &unit_test) override {
+    fprintf(stdout, "TEST %s\n", unit_test.Passed() ? "PASSED" : "FAILED");
+    fflush(stdout);
+  }
+};
+
+TEST(search, day) {
+  EXPECT_EQ(search_day(0), "1970-01-01");
+  EXPECT_EQ(search_day(search_day("2015-03-01")), "2015-03-01");
+  EXPECT_EQ(search_day("2015-03-01") - search_day("2015-02-28"), 1);
+  EXPECT_EQ(search_day("junk"), 0);
+}
+
+TEST(search, query) {
+  SearchRange range{.kind = SEARCH_USERS, .from = search_day("2015-01-01"), .to = search_day("2015-01-31")};
+  EXPECT_EQ(search_query(range), "type:user+created:2015-01-01..2015-01-31+followers:0..*");
+  range.kind = SEARCH_REPOS;
+  range.low = 5;
+  range.high = 10;
+  EXPECT_EQ(search_query(range), "created:2015-01-01..2015-01-31+stars:5..10");
+}
+
+TEST(search, split_days) {
+  SearchRange range = search_all(SEARCH_USERS, search_day("2007-10-29"));
+  SearchRange first, second;
+  ASSERT_TRUE(split_search(range, first, second));
+  EXPECT_EQ(search_day(first.from), "2007-10-20");
+  EXPECT_EQ(search_day(first.to), "2007-10-24");
+  EXPECT_EQ(search_day(second.from), "2007-10-25");
+  EXPECT_EQ(search_day(second.to), "2007-10-29");
+  EXPECT_EQ(first.high, -1);
+}
+
+TEST(search, split_counts) {
+  SearchRange range{.kind = SEARCH_REPOS, .from = 100, .to = 100};
+  SearchRange first, second;
+  ASSERT_TRUE(split_search(range, first, second));
+  EXPECT_EQ(first.low, 0);
+  EXPECT_EQ(first.high, 10);
+  EXPECT_EQ(second.low, 11);
+  EXPECT_EQ(second.high, -1);
+
+  // every range is cut down to a single day and count in the end, the slices cover it without overlap
+  int64_t covered = 0;
+  std::vector<SearchRange> ranges{first};
+  while (!ranges.empty()) {
+    SearchRange current = ranges.back();
+    ranges.pop_back();
+    SearchRange a, b;
+    if (split_search(current, a, b)) {
+      EXPECT_EQ(a.high + 1, b.low);
+      ranges.push_back(a);
+      ranges.push_back(b);
+    } else {
+      EXPECT_EQ(current.low, current.high);
+      covered++;
+    }
+  }
+  EXPECT_EQ(covered, 11);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  testing::UnitTest &unit_test = *testing::UnitTest::GetInstance();
+  testing::TestEventListeners &listeners = unit_test.listeners();
+  delete listeners.Release(listeners.default_result_printer());
+  listeners.Append(new TersePrinter);
+  return RUN_ALL_TESTS();
+}
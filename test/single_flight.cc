@@ -0,0 +1,81 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <single_flight.h>
+
+namespace {
+
+class TersePrinter : public testing::EmptyTestEventListener {
+private:
+  void OnTestProgramStart(const testing::UnitTest & /* unit_test */) override {}
+
+  void OnTestProgramEnd(const testing::UnitTest &unit_test) override {
+    fprintf(stdout, "TEST %s\n", unit_test.Passed() ? "PASSED" : "FAILED");
+    fflush(stdout);
+  }
+};
+
+TEST(single_flight, coalesce) {
+  SingleFlight<int> flight;
+  std::atomic<int> calls = 0;
+  std::atomic<int> shared_count = 0;
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([&]() {
+      bool shared = false;
+      int result = flight.run(
+          "/users/octocat", [&]() {
+            calls++;
+            released.wait();
+            return 42;
+          },
+          shared);
+      EXPECT_EQ(result, 42);
+      if (shared) {
+        shared_count++;
+      }
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  release.set_value();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(calls, 1);
+  EXPECT_EQ(shared_count, 7);
+}
+
+TEST(single_flight, sequential) {
+  SingleFlight<int> flight;
+  int calls = 0;
+  bool shared = true;
+  EXPECT_EQ(flight.run("a", [&]() { return ++calls; }, shared), 1);
+  EXPECT_FALSE(shared);
+  EXPECT_EQ(flight.run("a", [&]() { return ++calls; }, shared), 2);
+  EXPECT_FALSE(shared);
+  EXPECT_EQ(flight.run("b", [&]() { return ++calls; }, shared), 3);
+}
+
+TEST(single_flight, exception) {
+  SingleFlight<int> flight;
+  bool shared = false;
+  EXPECT_THROW(flight.run("a", []() -> int { throw std::runtime_error("x"); }, shared), std::runtime_error);
+  EXPECT_EQ(flight.run("a", []() { return 1; }, shared), 1);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  testing::UnitTest &unit_test = *testing::UnitTest::GetInstance();
+  testing::TestEventListeners &listeners = unit_test.listeners();
+  delete listeners.Release(listeners.default_result_printer());
+  listeners.Append(new TersePrinter);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,142 @@
+#include <unistd.h>
+
+#include <cstdio>
+#include <ctime>
+
+#include <CLI/CLI.hpp>
+#include <gtest/gtest.h>
+
+#include <database/mongo.h>
+#include <tokens.h>
+
+std::string dsn;
+std::string worker; // the test runs as one of the replicas if set
+std::string token = fmt::format("token_budget_test_{}", getpid());
+int64_t window = (std::time(nullptr) / 3600 + 1) * 3600; // the budget documents expire an hour after the window
+
+const int64_t BUDGET_CAP = 1000;
+const int64_t BUDGET_CHUNK = 7;
+const int BUDGET_REPLICAS = 4;
+
+namespace {
+
+class TersePrinter : public testing::EmptyTestEventListener {
+private:
+  void OnTestProgramStart(const testing::UnitTest & /* unit_test */) override {}
+
+  void OnTestProgramEnd(const testing::UnitTest &unit_test) override {
+    fprintf(stdout, "TEST %s\n", unit_test.Passed() ? "PASSED" : "FAILED");
+    fflush(stdout);
+  }
+};
+
+// replica reserves chunks of the budget until it is spent and prints the requests it got
+int replica() {
+  spdlog::set_level(spdlog::level::warn);
+  Mongo *mongo = new Mongo(dsn);
+  if (mongo->initialize() != 0) {
+    return EXIT_FAILURE;
+  }
+  int64_t total = 0;
+  while (true) {
+    int64_t granted = mongo->reserve_token_budget(token, RESOURCE_CORE, window, BUDGET_CAP, BUDGET_CHUNK);
+    if (granted <= 0) {
+      break;
+    }
+    total += granted;
+  }
+  fprintf(stdout, "granted %ld\n", total);
+  fflush(stdout);
+  delete mongo;
+  return EXIT_SUCCESS;
+}
+
+TEST(token_budget, replicas) {
+  std::vector<FILE *> replicas;
+  for (int i = 0; i < BUDGET_REPLICAS; i++) {
+    std::string command = fmt::format("/proc/{}/exe --dsn '{}' --token {} --window {} --worker replica{}", getpid(), dsn, token, window, i);
+    FILE *pipe = popen(command.c_str(), "r");
+    ASSERT_NE(pipe, nullptr);
+    replicas.push_back(pipe);
+  }
+  int64_t total = 0;
+  for (FILE *pipe : replicas) {
+    char line[256];
+    while (fgets(line, sizeof(line), pipe) != nullptr) {
+      long granted = 0;
+      if (sscanf(line, "granted %ld", &granted) == 1) { // the rest is the log of the replica
+        EXPECT_GT(granted, 0);
+        total += granted;
+      }
+    }
+    EXPECT_EQ(pclose(pipe), 0);
+  }
+  EXPECT_EQ(total, BUDGET_CAP);
+}
+
+TEST(token_budget, scheduler) {
+  Mongo *mongo = new Mongo(dsn);
+  ASSERT_EQ(mongo->initialize(), 0);
+  std::string scheduler_token = token + "_scheduler";
+  TokenScheduler tokens({scheduler_token}, 0);
+  tokens.set(0, RESOURCE_CORE, 20, 1000, std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count() + 3600);
+  tokens.share(
+      [&](int index, const std::string &resource, int64_t window, int64_t cap, int64_t chunk) {
+        return mongo->reserve_token_budget(tokens.id(index), resource, window, cap, chunk);
+      },
+      BUDGET_CHUNK);
+
+  for (int i = 0; i < 20; i++) {
+    ASSERT_EQ(tokens.acquire(), 0);
+  }
+  std::thread stopper([&tokens]() {
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    tokens.stop();
+  });
+  EXPECT_EQ(tokens.acquire(), -1); // the token has budget left, the shared budget is spent until the reset
+  stopper.join();
+  delete mongo;
+}
+
+// a token without a reported reset is probed by a single request, nothing of the shared budget is reserved
+TEST(token_budget, unknown_reset) {
+  TokenScheduler tokens({token + "_unknown"}, 0);
+  int reserved = 0;
+  tokens.share(
+      [&](int /* index */, const std::string & /* resource */, int64_t /* window */, int64_t /* cap */, int64_t chunk) {
+        reserved++;
+        return chunk;
+      },
+      BUDGET_CHUNK);
+
+  ASSERT_EQ(tokens.acquire(), 0);
+  std::thread stopper([&tokens]() {
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    tokens.stop();
+  });
+  EXPECT_EQ(tokens.acquire(), -1); // the probe is in flight
+  stopper.join();
+  EXPECT_EQ(reserved, 0);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  CLI::App app{"MongoDB token budget test"};
+  app.add_option("--dsn", dsn, "mongodb dsn");
+  app.add_option("--token", token, "token id of the budget");
+  app.add_option("--window", window, "window of the budget");
+  app.add_option("--worker", worker, "run as the replica");
+  CLI11_PARSE(app, argc, argv)
+
+  if (!worker.empty()) {
+    return replica();
+  }
+
+  testing::UnitTest &unit_test = *testing::UnitTest::GetInstance();
+  testing::TestEventListeners &listeners = unit_test.listeners();
+  delete listeners.Release(listeners.default_result_printer());
+  listeners.Append(new TersePrinter);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,126 @@
+#include <unistd.h>
+
+#include <CLI/CLI.hpp>
+#include <gtest/gtest.h>
+
+#include <database/mongo.h>
+#include <events.h>
+
+std::string dsn;
+std::string owner = fmt::format("touch_repos_test_{}", getpid());
+
+namespace {
+
+class TersePrinter : public testing::EmptyTestEventListener {
+private:
+  void OnTestProgramStart(const testing::UnitTest & /* unit_test */) override {}
+
+  void OnTestProgramEnd(const testing::UnitTest &unit_test) override {
+    fprintf(stdout, "TEST %s\n", unit_test.Passed() ? "PASSED" : "FAILED");
+    fflush(stdout);
+  }
+};
+
+Repo make_repo(const std::string &name) {
+  Repo repo{};
+  repo.name = name;
+  repo.owner = owner;
+  repo.full_name = owner + "/" + name;
+  repo.pushed_at = "2021-09-12T13:13:00Z";
+  repo.stargazers_count = 10;
+  repo.watchers_count = 10;
+  repo.watchers = 10;
+  repo.forks_count = 3;
+  repo.forks = 3;
+  return repo;
+}
+
+nlohmann::json watch_event(int64_t id, const std::string &name) {
+  return nlohmann::json{
+      {"id", std::to_string(id)},
+      {"type", "WatchEvent"},
+      {"actor", {{"id", 1}, {"login", "tosone"}}},
+      {"repo", {{"id", 2}, {"name", owner + "/" + name}}},
+      {"payload", {{"action", "started"}}},
+      {"created_at", "2021-09-12T13:13:00Z"},
+  };
+}
+
+TEST(touch_repos, pushed_at) {
+  Mongo *mongo = new Mongo(dsn);
+  EXPECT_EQ(mongo->initialize(), 0);
+  EXPECT_EQ(mongo->upsert_repo(make_repo("pushed")), 0);
+
+  EXPECT_EQ(mongo->touch_repos({RepoActivity{.owner = owner, .name = "pushed", .pushed_at = "2021-09-11T00:00:00Z"}}), 0);
+  EXPECT_EQ(mongo->get_repo(owner, "pushed").pushed_at, "2021-09-12T13:13:00Z"); // an older push does not move it back
+
+  EXPECT_EQ(mongo->touch_repos({RepoActivity{.owner = owner, .name = "pushed", .pushed_at = "2021-09-13T00:00:00Z"}}), 0);
+  Repo repo = mongo->get_repo(owner, "pushed");
+  EXPECT_EQ(repo.pushed_at, "2021-09-13T00:00:00Z");
+  EXPECT_EQ(repo.stargazers_count, 10);
+}
+
+TEST(touch_repos, counts) {
+  Mongo *mongo = new Mongo(dsn);
+  EXPECT_EQ(mongo->initialize(), 0);
+  EXPECT_EQ(mongo->upsert_repo(make_repo("counts")), 0);
+
+  EXPECT_EQ(mongo->touch_repos({RepoActivity{.owner = owner, .name = "counts", .stars = 2, .forks = 1},
+                                RepoActivity{.owner = owner, .name = "unknown", .stars = 5}}),
+            0);
+  Repo repo = mongo->get_repo(owner, "counts");
+  EXPECT_EQ(repo.stargazers_count, 12);
+  EXPECT_EQ(repo.watchers_count, 12);
+  EXPECT_EQ(repo.watchers, 12);
+  EXPECT_EQ(repo.forks_count, 4);
+  EXPECT_EQ(repo.forks, 4);
+  EXPECT_TRUE(mongo->get_repo(owner, "unknown").name.empty()); // an unknown repo is left to the crawl
+
+  EXPECT_EQ(mongo->touch_repos({}), 0);
+}
+
+TEST(advance_events, newest) {
+  Mongo *mongo = new Mongo(dsn);
+  EXPECT_EQ(mongo->initialize(), 0);
+
+  int64_t stored = mongo->advance_events(0);
+  ASSERT_GE(stored, 0);
+  EXPECT_EQ(mongo->advance_events(stored + 10), stored);
+  EXPECT_EQ(mongo->advance_events(stored + 10), stored + 10); // handled by another replica
+  EXPECT_EQ(mongo->advance_events(stored + 5), stored + 10);  // an older page does not move it back
+}
+
+// two replicas, or one restarted, poll the same page, the stars of its events are added once
+TEST(advance_events, replay) {
+  Mongo *mongo = new Mongo(dsn);
+  EXPECT_EQ(mongo->initialize(), 0);
+  EXPECT_EQ(mongo->upsert_repo(make_repo("replay")), 0);
+
+  int64_t stored = mongo->advance_events(0);
+  ASSERT_GE(stored, 0);
+  nlohmann::json page = nlohmann::json::array({watch_event(stored + 2, "replay"), watch_event(stored + 1, "replay")});
+  for (int replica = 0; replica < 2; replica++) {
+    EventActions actions = event_actions(page, 0); // nothing handled in the memory of the replica
+    int64_t before = mongo->advance_events(actions.last);
+    ASSERT_GE(before, 0);
+    actions = event_actions(page, before);
+    EXPECT_EQ(actions.count, replica == 0 ? 2 : 0);
+    EXPECT_EQ(mongo->touch_repos(actions.repos), 0);
+  }
+  EXPECT_EQ(mongo->get_repo(owner, "replay").stargazers_count, 12);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  CLI::App app{"MongoDB events test"};
+  app.add_option("--dsn", dsn, "mongodb dsn");
+  CLI11_PARSE(app, argc, argv)
+
+  testing::UnitTest &unit_test = *testing::UnitTest::GetInstance();
+  testing::TestEventListeners &listeners = unit_test.listeners();
+  delete listeners.Release(listeners.default_result_printer());
+  listeners.Append(new TersePrinter);
+  return RUN_ALL_TESTS();
+}
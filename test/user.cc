@@ -0,0 +1,156 @@
+#include <unistd.h>
+
+#include <algorithm>
+
+#include <CLI/CLI.hpp>
+#include <gtest/gtest.h>
+
+#include <database/mongo.h>
+
+std::string dsn;
+int64_t base_id = 1000000000000 + getpid() * 100; // far from the ids of github, unique for the run
+
+const int64_t PROFILE_TTL = 3600;
+
+namespace {
+
+class TersePrinter : public testing::EmptyTestEventListener {
+private:
+  void OnTestProgramStart(const testing::UnitTest & /* unit_test */) override {}
+
+  void OnTestProgramEnd(const testing::UnitTest &unit_test) override {
+    fprintf(stdout, "TEST %s\n", unit_test.Passed() ? "PASSED" : "FAILED");
+    fflush(stdout);
+  }
+};
+
+User make_user(int64_t offset) {
+  return User{.id = base_id + offset, .login = fmt::format("user_test_{}", base_id + offset)};
+}
+
+bool contains(const std::vector<std::string> &logins, const std::string &login) {
+  return std::find(logins.begin(), logins.end(), login) != logins.end();
+}
+
+// stale returns true if the login is sampled by list_users_stale, the sample is random, so it is asked a few times
+bool stale(Mongo *mongo, const std::string &login, int64_t ttl = PROFILE_TTL) {
+  for (int i = 0; i < 20; i++) {
+    if (contains(mongo->list_users_stale(ttl), login)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<std::string> fresh_logins(Mongo *mongo, const std::vector<std::string> &logins) {
+  std::vector<std::string> fresh;
+  for (const User &user : mongo->list_users_fresh(logins, PROFILE_TTL)) {
+    fresh.push_back(user.login);
+  }
+  return fresh;
+}
+
+TEST(user, stub_keeps_profile) {
+  Mongo *mongo = new Mongo(dsn);
+  EXPECT_EQ(mongo->initialize(), 0);
+
+  User user = make_user(0);
+  user.followers = 42;
+  user.public_repos = 7;
+  EXPECT_EQ(mongo->upsert_user(user), 0);
+  EXPECT_EQ(mongo->upsert_user_stub({make_user(0)}), 0);
+
+  std::vector<User> fresh = mongo->list_users_fresh({user.login}, PROFILE_TTL);
+  ASSERT_EQ(fresh.size(), 1);
+  EXPECT_EQ(fresh[0].login, user.login);
+  EXPECT_EQ(fresh[0].followers, 42);
+  EXPECT_EQ(fresh[0].public_repos, 7);
+}
+
+TEST(user, stub_is_stale) {
+  Mongo *mongo = new Mongo(dsn);
+  EXPECT_EQ(mongo->initialize(), 0);
+
+  User stub = make_user(1);
+  EXPECT_EQ(mongo->upsert_user_stub({stub}), 0);
+  EXPECT_TRUE(fresh_logins(mongo, {stub.login}).empty());
+  EXPECT_TRUE(stale(mongo, stub.login));
+}
+
+// hydrate upserts the profile of a stub, the user turns fresh and is not sampled again until the ttl passes
+TEST(user, hydrate) {
+  Mongo *mongo = new Mongo(dsn);
+  EXPECT_EQ(mongo->initialize(), 0);
+
+  User stub = make_user(2);
+  EXPECT_EQ(mongo->upsert_user_stub({stub}), 0);
+  EXPECT_TRUE(stale(mongo, stub.login));
+
+  User profile = make_user(2);
+  profile.followers = 3;
+  EXPECT_EQ(mongo->upsert_user(profile), 0);
+  EXPECT_EQ(fresh_logins(mongo, {stub.login}), std::vector<std::string>{stub.login});
+  EXPECT_FALSE(stale(mongo, stub.login));
+}
+
+TEST(user, fresh_only_asked) {
+  Mongo *mongo = new Mongo(dsn);
+  EXPECT_EQ(mongo->initialize(), 0);
+
+  EXPECT_EQ(mongo->upsert_user(make_user(3)), 0);
+  EXPECT_EQ(mongo->upsert_user(make_user(4)), 0);
+  EXPECT_EQ(mongo->upsert_user_stub({make_user(5)}), 0);
+
+  std::vector<std::string> fresh = fresh_logins(mongo, {make_user(3).login, make_user(5).login});
+  EXPECT_EQ(fresh, std::vector<std::string>{make_user(3).login});
+  EXPECT_TRUE(mongo->list_users_fresh({}, PROFILE_TTL).empty());
+}
+
+// touch_users marks a stub answered with 304 as fresh, it is not sampled again
+TEST(user, touch) {
+  Mongo *mongo = new Mongo(dsn);
+  EXPECT_EQ(mongo->initialize(), 0);
+
+  User stub = make_user(6);
+  EXPECT_EQ(mongo->upsert_user_stub({stub}), 0);
+  EXPECT_TRUE(fresh_logins(mongo, {stub.login}).empty());
+
+  EXPECT_EQ(mongo->touch_users({std::to_string(stub.id)}), 0);
+  EXPECT_EQ(fresh_logins(mongo, {stub.login}), std::vector<std::string>{stub.login});
+  EXPECT_FALSE(stale(mongo, stub.login));
+  EXPECT_EQ(mongo->touch_users({}), 0);
+}
+
+// a profile with a change history is stale when its next visit is due, the ttl covers the ones without
+TEST(user, scheduled) {
+  Mongo *mongo = new Mongo(dsn);
+  EXPECT_EQ(mongo->initialize(), 0);
+
+  User scheduled = make_user(7);
+  User unscheduled = make_user(8);
+  EXPECT_EQ(mongo->upsert_user(scheduled), 0);
+  EXPECT_EQ(mongo->upsert_user(unscheduled), 0);
+  EXPECT_EQ(mongo->observe_revisits("users", {{scheduled.login, "2021-09-12T13:13:00Z"}}, 3600, 3600), 0);
+
+  EXPECT_FALSE(stale(mongo, scheduled.login, 0)); // fetched before the ttl of 0, but not due for an hour
+  EXPECT_TRUE(stale(mongo, unscheduled.login, 0));
+  EXPECT_FALSE(stale(mongo, unscheduled.login));
+
+  EXPECT_EQ(mongo->observe_revisits("users", {{scheduled.login, "2021-09-12T13:13:00Z"}}, 0, 0), 0);
+  EXPECT_TRUE(stale(mongo, scheduled.login)); // due right away, fresh by the ttl
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  CLI::App app{"MongoDB users test"};
+  app.add_option("--dsn", dsn, "mongodb dsn");
+  CLI11_PARSE(app, argc, argv)
+
+  testing::UnitTest &unit_test = *testing::UnitTest::GetInstance();
+  testing::TestEventListeners &listeners = unit_test.listeners();
+  delete listeners.Release(listeners.default_result_printer());
+  listeners.Append(new TersePrinter);
+  return RUN_ALL_TESTS();
+}